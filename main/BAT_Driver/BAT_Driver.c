@@ -1,11 +1,14 @@
 #include "BAT_Driver.h"
+#include "Driver_Events.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_timer.h"
 
 const static char *ADC_TAG = "ADC";
 
 float BAT_analogVolts = 0;
 
 /*---------------------------------------------------------------
-        ADC Calibration  
+        ADC Calibration
 ---------------------------------------------------------------*/
 static bool example_adc_calibration_init(adc_unit_t unit, adc_channel_t channel, adc_atten_t atten, adc_cali_handle_t *out_handle)
 {
@@ -68,50 +71,130 @@ static bool example_adc_calibration_init(adc_unit_t unit, adc_channel_t channel,
 // #endif
 // }
 
-adc_oneshot_unit_handle_t adc1_handle;
 bool do_calibration1_chan3;
 adc_cali_handle_t adc1_cali_chan3_handle = NULL;
 
-int adc_raw[2][10];                           
-int voltage[2][10];                          
-void ADC_Init(void)
+/*---------------------------------------------------------------
+        Supply monitor state
+  Written only by BAT_Feed(), from either the thermistor consumer task
+  or the oneshot fallback timer, never both; readers take single aligned
+  32-bit loads.
+---------------------------------------------------------------*/
+static volatile int32_t s_supply_mv = -1;       // Filtered
+static volatile bool s_brownout = false;
+static float s_filter_mv = 0.0f;
+static uint32_t s_low_blocks = 0;
+static uint32_t s_good_blocks = 0;
+
+/** Block average code -> supply millivolts, calibrated when the eFuse allows it */
+static int32_t code_to_supply_mv(uint32_t code)
 {
-    //-------------ADC1 Init---------------//
-    adc_oneshot_unit_init_cfg_t init_config1 = {                          
-        .unit_id = ADC_UNIT_1,                                               
-    };
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config1, &adc1_handle));      
+    int pin_mv = 0;
+    if (!do_calibration1_chan3 || adc_cali_raw_to_voltage(adc1_cali_chan3_handle, (int)code, &pin_mv) != ESP_OK) {
+        pin_mv = (int)((code * 3300u) / 4095u);
+    }
+    return (int32_t)(pin_mv * BAT_DIVIDER / Measurement_offset);
+}
+
+void BAT_Init(void)
+{
+    // The ADC unit is owned by the continuous scan (Thermistor_Init), or by BAT_Start_Oneshot() if that is not running
+    do_calibration1_chan3 = example_adc_calibration_init(BAT_ADC_UNIT, BAT_ADC_CHANNEL, EXAMPLE_ADC_ATTEN, &adc1_cali_chan3_handle);
+}
+
+void BAT_Feed(uint32_t raw_sum, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    int32_t mv = code_to_supply_mv(raw_sum / count);
+
+    /* Brown-out decision on the unfiltered block: the filter would add
+     * half a second of lag exactly when it matters */
+    bool was = s_brownout;
+    if (mv < BAT_BROWNOUT_MV) {
+        s_good_blocks = 0;
+        if (++s_low_blocks >= BAT_BROWNOUT_BLOCKS) {
+            s_brownout = true;
+        }
+    } else {
+        s_low_blocks = 0;
+        if (mv > BAT_RECOVER_MV && ++s_good_blocks >= BAT_RECOVER_BLOCKS) {
+            s_brownout = false;
+        }
+    }
+    if (s_brownout != was) {
+        Driver_Events_Post(DRIVER_EVT_SUPPLY);
+    }
+
+    if (s_supply_mv < 0) {
+        s_filter_mv = (float)mv;
+    } else {
+        s_filter_mv += BAT_FILTER_ALPHA * ((float)mv - s_filter_mv);
+    }
+    s_supply_mv = (int32_t)(s_filter_mv + 0.5f);
+    BAT_analogVolts = s_filter_mv / 1000.0f;
+}
 
-    //-------------ADC1 Config---------------//
+/*---------------------------------------------------------------
+        Oneshot fallback
+---------------------------------------------------------------*/
+static adc_oneshot_unit_handle_t adc1_handle = NULL;
+static esp_timer_handle_t oneshot_timer = NULL;
+
+static void oneshot_timer_cb(void *arg)
+{
+    uint32_t sum = 0;
+    uint32_t count = 0;
+    for (int i = 0; i < BAT_ONESHOT_READS; i++) {
+        int raw;
+        if (adc_oneshot_read(adc1_handle, BAT_ADC_CHANNEL, &raw) == ESP_OK) {
+            sum += (uint32_t)raw;
+            count++;
+        }
+    }
+    BAT_Feed(sum, count);
+}
+
+void BAT_Start_Oneshot(void)
+{
+    if (oneshot_timer) {
+        return;
+    }
+    adc_oneshot_unit_init_cfg_t init_config = {
+        .unit_id = BAT_ADC_UNIT,
+    };
+    esp_err_t ret = adc_oneshot_new_unit(&init_config, &adc1_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(ADC_TAG, "Supply monitor unavailable: %s", esp_err_to_name(ret));
+        return;
+    }
     adc_oneshot_chan_cfg_t config = {
-        .atten = EXAMPLE_ADC_ATTEN,                                               
+        .atten = EXAMPLE_ADC_ATTEN,
         .bitwidth = ADC_BITWIDTH_DEFAULT,
     };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, EXAMPLE_ADC1_CHAN3, &config)); 
+    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, BAT_ADC_CHANNEL, &config));
 
-    //-------------ADC1 Calibration Init---------------//
-    do_calibration1_chan3 = example_adc_calibration_init(ADC_UNIT_1, EXAMPLE_ADC1_CHAN3, EXAMPLE_ADC_ATTEN, &adc1_cali_chan3_handle);     
+    const esp_timer_create_args_t timer_args = {
+        .callback = oneshot_timer_cb,
+        .name = "bat_oneshot",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &oneshot_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(oneshot_timer, BAT_ONESHOT_PERIOD_MS * 1000));
+    ESP_LOGW(ADC_TAG, "Supply monitor on oneshot reads (%d ms blocks)", BAT_ONESHOT_PERIOD_MS);
+}
 
-    // //Tear Down
-    // ESP_ERROR_CHECK(adc_oneshot_del_unit(adc1_handle));
-    // if (do_calibration1_chan3) {                                                                                                                
-    //     example_adc_calibration_deinit(adc1_cali_chan3_handle);                                                                                 
-    // }
+float BAT_Get_Volts(void)
+{
+    return BAT_analogVolts;
 }
 
-void BAT_Init(void)
+int32_t BAT_Get_Supply_mV(void)
 {
-    ADC_Init();
+    return s_supply_mv;
 }
-float BAT_Get_Volts(void)
+
+bool BAT_Brownout(void)
 {
-    adc_oneshot_read(adc1_handle, EXAMPLE_ADC1_CHAN3, &adc_raw[0][0]);                                                     
-    // printf( "ADC%d Channel[%d] Raw Data: %d\r\n", ADC_UNIT_1 + 1, EXAMPLE_ADC1_CHAN3, adc_raw[0][0]);                                                
-    if (do_calibration1_chan3) {                                                                                           
-        ESP_ERROR_CHECK(adc_cali_raw_to_voltage(adc1_cali_chan3_handle, adc_raw[0][0], &voltage[0][0]));                    
-        // printf("ADC%d Channel[%d] Cali Voltage: %d mV\r\n", ADC_UNIT_1 + 1, EXAMPLE_ADC1_CHAN3, voltage[0][0]);                
-        BAT_analogVolts = (float)(voltage[0][0] * 3.0 / 1000.0) / Measurement_offset;
-        // printf("BAT voltage : %.2f V\r\n", BAT_analogVolts);
-    }
-    return BAT_analogVolts;
-}
\ No newline at end of file
+    return s_brownout;
+}
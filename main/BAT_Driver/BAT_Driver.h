@@ -1,7 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "esp_log.h"
-#include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
 
@@ -13,9 +14,46 @@
 #define EXAMPLE_ADC1_CHAN3          ADC_CHANNEL_3              // GPIO4
 #define EXAMPLE_ADC_ATTEN           ADC_ATTEN_DB_12             // ADC_ATTEN_DB_12
 
-#define Measurement_offset 0.994500  
+#define Measurement_offset 0.994500
 
-extern float BAT_analogVolts;
+/*---------------------------------------------------------------
+        Supply monitor
+  The battery/supply divider (1/3) on GPIO4 is one more entry in the
+  thermistor continuous-ADC scan (Thermistor.c), so nothing blocks on a
+  oneshot read. Every BAT_FEED_SCANS scans (50 ms at 2 kHz) the consumer
+  task hands the sum to BAT_Feed(), which calibrates it, checks it against
+  the brown-out threshold and updates a slow IIR for display and logging.
+  On a brown-out (and on recovery) DRIVER_EVT_SUPPLY is posted so the
+  driver task can close the SD log and hold off settings writes before
+  the rail collapses during cranking or shutdown.
+  If the scan does not run (it failed to start, or no thermistor channel
+  is enabled), Thermistor_Init() calls BAT_Start_Oneshot() instead and a
+  timer feeds the same blocks from oneshot reads.
+---------------------------------------------------------------*/
+#define BAT_MONITOR_ENABLED         1                   // 0 frees GPIO4 for THERM_AMBIENT
+#define BAT_GPIO                    4
+#define BAT_ADC_UNIT                ADC_UNIT_1
+#define BAT_ADC_CHANNEL             EXAMPLE_ADC1_CHAN3
+#define BAT_DIVIDER                 3                   // Supply = pin voltage x 3
+#define BAT_FEED_SCANS              100                 // Scans per BAT_Feed() block (50 ms)
+#define BAT_FILTER_ALPHA            0.1f                // IIR weight per block (~0.5 s time constant)
+#define BAT_BROWNOUT_MV             3500                // Block average below this -> brown-out
+#define BAT_RECOVER_MV              3700                // ... and above this again to recover
+#define BAT_BROWNOUT_BLOCKS         2                   // Consecutive low blocks to trip (100 ms, rejects ignition spikes)
+#define BAT_RECOVER_BLOCKS          40                  // Consecutive good blocks to recover (2 s)
+#define BAT_ONESHOT_PERIOD_MS       50                  // Fallback: one block per timer tick
+#define BAT_ONESHOT_READS           16                  // Fallback: oneshot reads per block
+
+extern float BAT_analogVolts;                           // Filtered supply in V (kept for the UI)
 
 void BAT_Init(void);
-float BAT_Get_Volts(void);
\ No newline at end of file
+// Filtered supply voltage in V, O(1), never touches the ADC. 0 until the first block
+float BAT_Get_Volts(void);
+// Filtered supply voltage in mV, -1 if not monitored or no reading yet
+int32_t BAT_Get_Supply_mV(void);
+// True from a confirmed dip below BAT_BROWNOUT_MV until BAT_RECOVER_BLOCKS above BAT_RECOVER_MV
+bool BAT_Brownout(void);
+// One block of raw ADC codes from the continuous scan. Called by the thermistor consumer task only
+void BAT_Feed(uint32_t raw_sum, uint32_t count);
+// Sample the supply with its own ADC1 oneshot reads, for when the continuous scan is not running
+void BAT_Start_Oneshot(void);
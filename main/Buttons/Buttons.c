@@ -7,6 +7,7 @@
 #include "freertos/task.h"
 #include "freertos/timers.h"
 #include "esp_log.h"
+#include "Driver_Events.h"
 
 static const char *BTN_TAG = "Buttons";
 
@@ -27,11 +28,13 @@ static TimerHandle_t tank_debounce_timer = NULL;
 static void power_debounce_cb(TimerHandle_t timer)
 {
     power_raw_pressed = (gpio_get_level(BUTTON_POWER_GPIO) == 0);
+    Driver_Events_Post(DRIVER_EVT_BUTTON);
 }
 
 static void tank_debounce_cb(TimerHandle_t timer)
 {
     tank_raw_pressed = (gpio_get_level(BUTTON_TANK_GPIO) == 0);
+    Driver_Events_Post(DRIVER_EVT_BUTTON);
 }
 
 /***********************
@@ -70,6 +73,10 @@ void Buttons_Init(void)
     };
     ESP_ERROR_CHECK(gpio_config(&btn_cfg));
 
+    // Switch positions at boot: the ISRs only see later edges
+    power_raw_pressed = (gpio_get_level(BUTTON_POWER_GPIO) == 0);
+    tank_raw_pressed  = (gpio_get_level(BUTTON_TANK_GPIO) == 0);
+
     esp_err_t isr_ret = gpio_install_isr_service(0);
     if (isr_ret != ESP_OK && isr_ret != ESP_ERR_INVALID_STATE) {
         ESP_ERROR_CHECK(isr_ret);
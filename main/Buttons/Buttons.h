@@ -12,7 +12,7 @@
  *  BUTTONS OFF (debugging):   Set ENABLE_BUTTONS=0 below
  *              + sdkconfig:   CONFIG_ESP_CONSOLE_UART_DEFAULT=y
  *
- *  NOTE: USB logging is unavailable either way (GPIO19 = thermistor)
+ *  NOTE: USB logging is unavailable either way (GPIO19/20 = thermistors)
  ***********************/
 #define ENABLE_BUTTONS   0
 
@@ -2,9 +2,66 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 
 static const char *EXIO_TAG = "EXIO";
 
+/*****************************************************  Shadow registers   ****************************************************/
+/* Write-through copies of the output and config registers. Pin updates are
+ * computed from the shadow and written in one transaction instead of a
+ * read-modify-write, and s_exio_mutex makes compute + write atomic between
+ * tasks (LCD/touch reset, SD D3, buzzer, spray relay). Values are the
+ * chip's power-on defaults until EXIO_Resync() reads the real ones. */
+static uint8_t s_output_shadow = 0xFF;
+static uint8_t s_config_shadow = 0xFF;
+static SemaphoreHandle_t s_exio_mutex = NULL;
+
+static inline void exio_lock(void)
+{
+    if (s_exio_mutex) xSemaphoreTake(s_exio_mutex, portMAX_DELAY);
+}
+static inline void exio_unlock(void)
+{
+    if (s_exio_mutex) xSemaphoreGive(s_exio_mutex);
+}
+
+/** Write REG and update its shadow on success. Caller holds the lock. */
+static esp_err_t write_reg_locked(uint8_t REG, uint8_t Data)
+{
+    esp_err_t ret = I2C_Write(TCA9554_ADDRESS, REG, &Data, 1);
+    if (ret != ESP_OK) {
+        ESP_LOGW(EXIO_TAG, "Write_REG(0x%02X, 0x%02X) failed: %s", REG, Data, esp_err_to_name(ret));
+        return ret;
+    }
+    if (REG == TCA9554_OUTPUT_REG) s_output_shadow = Data;
+    else if (REG == TCA9554_CONFIG_REG) s_config_shadow = Data;
+    return ESP_OK;
+}
+
+/** Replace the bits in Mask with Bits in a shadowed register, one write if anything changes.
+ *  On failure the shadow keeps the old bits, so calling again retries the write. */
+static esp_err_t update_reg(uint8_t REG, uint8_t Mask, uint8_t Bits)
+{
+    esp_err_t ret = ESP_OK;
+    exio_lock();
+    uint8_t cur = (REG == TCA9554_OUTPUT_REG) ? s_output_shadow : s_config_shadow;
+    uint8_t next = (cur & ~Mask) | (Bits & Mask);
+    if (next != cur) {
+        ret = write_reg_locked(REG, next);
+    }
+    exio_unlock();
+    return ret;
+}
+
+static inline bool pin_valid(uint8_t Pin)
+{
+    if (Pin < 1 || Pin > 8) {
+        printf("Parameter error, please enter the correct parameter!\r\n");
+        return false;
+    }
+    return true;
+}
+
 /*****************************************************  Operation register REG   ****************************************************/   
 uint8_t Read_REG(uint8_t REG)                                // Read the value of the TCA9554PWR register REG
 {
@@ -15,24 +72,27 @@ uint8_t Read_REG(uint8_t REG)                                // Read the value o
     }
     return bitsStatus;
 }
-void Write_REG(uint8_t REG,uint8_t Data)                    // Write Data to the REG register of the TCA9554PWR
+void Write_REG(uint8_t REG,uint8_t Data)                    // Write Data to the REG register of the TCA9554PWR (keeps the shadow in step)
 {
-    esp_err_t ret = I2C_Write(TCA9554_ADDRESS, REG, &Data, 1);
-    if (ret != ESP_OK) {
-        ESP_LOGW(EXIO_TAG, "Write_REG(0x%02X, 0x%02X) failed: %s", REG, Data, esp_err_to_name(ret));
-    }
+    exio_lock();
+    write_reg_locked(REG, Data);
+    exio_unlock();
 }
 /********************************************************** Set EXIO mode **********************************************************/       
-void Mode_EXIO(uint8_t Pin,uint8_t State)                 // Set the mode of the TCA9554PWR Pin. The default is Output mode (output mode or input mode). State: 0= Output mode 1= input mode    
+esp_err_t Mode_EXIO(uint8_t Pin,uint8_t State)            // Set the mode of the TCA9554PWR Pin. The default is Output mode (output mode or input mode). State: 0= Output mode 1= input mode    
 {
-    uint8_t bitsStatus = Read_REG(TCA9554_CONFIG_REG);                                
-    uint8_t Data = (0x01 << (Pin-1)) | bitsStatus;  
-    Write_REG(TCA9554_CONFIG_REG,Data);            
+    if (!pin_valid(Pin) || State > 1) return ESP_ERR_INVALID_ARG;
+    uint8_t mask = 0x01 << (Pin-1);
+    return update_reg(TCA9554_CONFIG_REG, mask, State ? mask : 0);
 }
 void Mode_EXIOS(uint8_t PinState)                        // Set the mode of the 7 pins from the TCA9554PWR with PinState   
 {
     Write_REG(TCA9554_CONFIG_REG,PinState);                             
 }
+esp_err_t Mode_EXIOS_Masked(uint8_t Mask,uint8_t PinState) // Set the mode of the pins in Mask only, one transaction
+{
+    return update_reg(TCA9554_CONFIG_REG, Mask, PinState);
+}
 
 /********************************************************** Read EXIO status **********************************************************/       
 uint8_t Read_EXIO(uint8_t Pin)                            // Read the level of the TCA9554PWR Pin
@@ -46,33 +106,55 @@ uint8_t Read_EXIOS(void)                                  // Read the level of a
   uint8_t inputBits = Read_REG(TCA9554_INPUT_REG);                                     
   return inputBits;                                                                    
 }
+uint8_t Get_EXIO_Output(void)                             // Output levels last written (shadow, no I2C)
+{
+    return s_output_shadow;
+}
 
 /********************************************************** Set the EXIO output status **********************************************************/  
-void Set_EXIO(uint8_t Pin,uint8_t State)                  // Sets the level state of the Pin without affecting the other pins(PIN：1~8)
-{
-    uint8_t Data = 0;
-    uint8_t bitsStatus = Read_REG(TCA9554_OUTPUT_REG);         
-    if(State < 2 && Pin < 9 && Pin > 0){     
-        if(State == 1)                                     
-            Data = (0x01 << (Pin-1)) | bitsStatus;                 
-        else if(State == 0) 
-            Data = (~(0x01 << (Pin-1)) & bitsStatus);  
-        Write_REG(TCA9554_OUTPUT_REG,Data);
-    }
-    else                                                                             
-        printf("Parameter error, please enter the correct parameter!\r\n");
-
+esp_err_t Set_EXIO(uint8_t Pin,uint8_t State)             // Sets the level state of the Pin without affecting the other pins(PIN：1~8)
+{
+    if (!pin_valid(Pin) || State > 1) return ESP_ERR_INVALID_ARG;
+    uint8_t mask = 0x01 << (Pin-1);
+    return update_reg(TCA9554_OUTPUT_REG, mask, State ? mask : 0);
 }
 void Set_EXIOS(uint8_t PinState)                     // Set 7 pins to the PinState state such as :PinState=0x23, 0010 0011 state (the highest bit is not used)
 {
     Write_REG(TCA9554_OUTPUT_REG,PinState);                                            
 }
+esp_err_t Set_EXIOS_Masked(uint8_t Mask,uint8_t PinState) // Set the pins in Mask to the matching PinState bits atomically, one transaction
+{
+    return update_reg(TCA9554_OUTPUT_REG, Mask, PinState);
+}
 
 /********************************************************** Flip EXIO state **********************************************************/  
 void Set_Toggle(uint8_t Pin)                              // Flip the level of the TCA9554PWR Pin
 {
-    uint8_t bitsStatus = Read_EXIO(Pin);                                              
-    Set_EXIO(Pin,(bool)!bitsStatus);
+    if (!pin_valid(Pin)) return;
+    uint8_t mask = 0x01 << (Pin-1);
+    exio_lock();
+    write_reg_locked(TCA9554_OUTPUT_REG, s_output_shadow ^ mask);
+    exio_unlock();
+}
+
+/********************************************************** Resync the shadow **********************************************************/  
+esp_err_t EXIO_Resync(void)                               // Reload the output/config shadows from the chip (after a reset or bus error)
+{
+    uint8_t out = 0, cfg = 0;
+    exio_lock();
+    esp_err_t ret = I2C_Read(TCA9554_ADDRESS, TCA9554_OUTPUT_REG, &out, 1);
+    if (ret == ESP_OK) {
+        ret = I2C_Read(TCA9554_ADDRESS, TCA9554_CONFIG_REG, &cfg, 1);
+    }
+    if (ret == ESP_OK) {
+        s_output_shadow = out;
+        s_config_shadow = cfg;
+    }
+    exio_unlock();
+    if (ret != ESP_OK) {
+        ESP_LOGW(EXIO_TAG, "Resync failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
 }
 
 /******************************************* The I2C device is initialized. Procedure ***********************************************/  
@@ -103,6 +185,10 @@ esp_err_t EXIO_Init(void)
     /* Retry I2C communication with TCA9554 up to 10 times.
      * On cold boot the I/O expander may not be ready when the ESP32 starts.
      * Without verification, all LCD reset/CS commands fail silently. */
+    if (!s_exio_mutex) {
+        s_exio_mutex = xSemaphoreCreateMutex();
+    }
+
     esp_err_t ret = ESP_FAIL;
     for (int attempt = 0; attempt < 10; attempt++) {
         uint8_t test_val = 0;
@@ -119,6 +205,11 @@ esp_err_t EXIO_Init(void)
         return ret;
     }
 
+    /* Output latches survive an ESP32 reset, so start from the chip's values */
+    EXIO_Resync();
+#if I2C_BENCH
+    I2C_Bench(TCA9554_ADDRESS, TCA9554_OUTPUT_REG, s_output_shadow);   // Rewrites the current levels only
+#endif
     TCA9554PWR_Init(0x00);
 
     /* Verify the config register was actually written */
@@ -30,17 +30,21 @@
 uint8_t Read_REG(uint8_t REG);                              // Read the value of the TCA9554PWR register REG
 void Write_REG(uint8_t REG,uint8_t Data);                   // Write Data to the REG register of the TCA9554PWR
 /********************************************************** Set EXIO mode **********************************************************/       
-void Mode_EXIO(uint8_t Pin,uint8_t State);                  // Set the mode of the TCA9554PWR Pin. The default is Output mode (output mode or input mode). State: 0= Output mode 1= input mode   
+esp_err_t Mode_EXIO(uint8_t Pin,uint8_t State);             // Set the mode of the TCA9554PWR Pin. The default is Output mode (output mode or input mode). State: 0= Output mode 1= input mode   
 void Mode_EXIOS(uint8_t PinState);                          // Set the mode of the 7 pins from the TCA9554PWR with PinState  
+esp_err_t Mode_EXIOS_Masked(uint8_t Mask,uint8_t PinState); // Set the mode of only the pins in Mask (bit n = EXIO n+1), one transaction
 /********************************************************** Read EXIO status **********************************************************/       
 uint8_t Read_EXIO(uint8_t Pin);                             // Read the level of the TCA9554PWR Pin
 uint8_t Read_EXIOS(void);                                   // Read the level of all pins of TCA9554PWR, the default read input level state, want to get the current IO output state, pass the parameter TCA9554_OUTPUT_REG, such as Read_EXIOS(TCA9554_OUTPUT_REG);
+uint8_t Get_EXIO_Output(void);                              // Output levels last written, from the shadow register (no I2C)
 /********************************************************** Set the EXIO output status **********************************************************/  
-void Set_EXIO(uint8_t Pin,uint8_t State);                   // Sets the level state of the Pin without affecting the other pins
+esp_err_t Set_EXIO(uint8_t Pin,uint8_t State);              // Sets the level state of the Pin without affecting the other pins. On error the shadow is unchanged, so calling again retries
 void Set_EXIOS(uint8_t PinState);                           // Set 7 pins to the PinState state such as :PinState=0x23, 0010 0011 state (the highest bit is not used)
+esp_err_t Set_EXIOS_Masked(uint8_t Mask,uint8_t PinState);  // Set only the pins in Mask to their PinState bits, atomically in one transaction
 /********************************************************** Flip EXIO state **********************************************************/  
 void Set_Toggle(uint8_t Pin);                               // Flip the level of the TCA9554PWR Pin
 /********************************************************* TCA9554PWR Initializes the device ***********************************************************/  
 void TCA9554PWR_Init(uint8_t PinState);                     // Set the seven pins to PinState state, for example :PinState=0x23, 0010 0011 State (the highest bit is not used) (Output mode or input mode) 0= Output mode 1= Input mode. The default value is output mode
 
 esp_err_t EXIO_Init(void);
+esp_err_t EXIO_Resync(void);                                // Reload the output/config shadow registers from the chip (after a reset or bus error)
@@ -0,0 +1,29 @@
+#include "Driver_Events.h"
+#include "freertos/task.h"
+
+static TaskHandle_t s_receiver = NULL;
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Driver_Events_Register(void)
+{
+    s_receiver = xTaskGetCurrentTaskHandle();
+}
+
+void Driver_Events_Post(uint32_t bits)
+{
+    TaskHandle_t task = s_receiver;
+    if (task) {
+        xTaskNotify(task, bits, eSetBits);
+    }
+}
+
+uint32_t Driver_Events_Wait(TickType_t timeout)
+{
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &bits, timeout) != pdTRUE) {
+        return 0;
+    }
+    return bits;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+/***********************
+ *  DRIVER TASK EVENTS
+ *  The driver task sleeps in Driver_Events_Wait() until one of these bits
+ *  is posted, instead of polling every 100 ms. Bits are delivered with a
+ *  direct-to-task notification (eSetBits), so posting is cheap, never
+ *  blocks and several posts before the task runs merge into one wake-up.
+ ***********************/
+#define DRIVER_EVT_BUTTON       (1u << 0)   // Button debounce settled (Buttons.c)
+#define DRIVER_EVT_SENSOR       (1u << 1)   // New sample in the sensor ring (Thermistor.c)
+#define DRIVER_EVT_RTC_TICK     (1u << 2)   // One second elapsed (main.c)
+#define DRIVER_EVT_SPRAY        (1u << 3)   // Relay switched (Spray.c)
+#define DRIVER_EVT_SUPPLY       (1u << 4)   // Brown-out entered or cleared (BAT_Driver.c)
+
+#define DRIVER_EVT_ALL          (DRIVER_EVT_BUTTON | DRIVER_EVT_SENSOR | DRIVER_EVT_RTC_TICK | DRIVER_EVT_SPRAY | \
+                                 DRIVER_EVT_SUPPLY)
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Make the calling task the receiver of driver events. Call once from the driver task. */
+void Driver_Events_Register(void);
+
+/** Post events from task context. Dropped until a receiver is registered. */
+void Driver_Events_Post(uint32_t bits);
+
+/**
+ * Block until at least one event is posted, and clear what was returned.
+ * @return DRIVER_EVT_* bits, 0 on timeout
+ */
+uint32_t Driver_Events_Wait(TickType_t timeout);
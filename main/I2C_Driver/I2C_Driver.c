@@ -1,4 +1,13 @@
 #include "I2C_Driver.h"
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#if I2C_BENCH
+#include "esp_cpu.h"
+#endif
 
 static const char *I2C_TAG = "I2C";
 
@@ -9,11 +18,13 @@ typedef struct {
     uint8_t addr;
     i2c_master_dev_handle_t handle;
     bool used;
+    _Atomic uint32_t stats_seq;     /* Odd while the bus task updates stats */
+    i2c_dev_stats_t stats;
 } i2c_device_entry_t;
 
 i2c_master_bus_handle_t i2c_bus_handle = NULL;
 static i2c_device_entry_t device_cache[MAX_I2C_DEVICES];
-static int device_count = 0;
+static _Atomic int device_count = 0;    /* Entries are filled before the count is published */
 
 /**
  * @brief Get or create a device handle for the given I2C address
@@ -21,14 +32,15 @@ static int device_count = 0;
 static i2c_master_dev_handle_t get_or_add_device(uint8_t addr)
 {
     // Check cache first
-    for (int i = 0; i < device_count; i++) {
+    int count = atomic_load_explicit(&device_count, memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
         if (device_cache[i].used && device_cache[i].addr == addr) {
             return device_cache[i].handle;
         }
     }
 
     // Add new device to bus
-    assert(device_count < MAX_I2C_DEVICES);
+    assert(count < MAX_I2C_DEVICES);
 
     i2c_device_config_t dev_cfg = {
         .dev_addr_length = I2C_ADDR_BIT_LEN_7,
@@ -39,15 +51,324 @@ static i2c_master_dev_handle_t get_or_add_device(uint8_t addr)
     i2c_master_dev_handle_t dev_handle;
     ESP_ERROR_CHECK(i2c_master_bus_add_device(i2c_bus_handle, &dev_cfg, &dev_handle));
 
-    device_cache[device_count].addr = addr;
-    device_cache[device_count].handle = dev_handle;
-    device_cache[device_count].used = true;
-    device_count++;
+    device_cache[count].addr = addr;
+    device_cache[count].handle = dev_handle;
+    device_cache[count].used = true;
+    device_cache[count].stats.addr = addr;
+    atomic_store_explicit(&device_count, count + 1, memory_order_release);
 
     ESP_LOGI(I2C_TAG, "Added I2C device at address 0x%02X", addr);
     return dev_handle;
 }
 
+static i2c_device_entry_t *find_device(uint8_t addr)
+{
+    int count = atomic_load_explicit(&device_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (device_cache[i].addr == addr) {
+            return &device_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/********************* Statistics *********************/
+/* Only the bus task (or the boot thread before it starts) writes stats; a
+ * per-device sequence counter lets readers take a consistent copy without
+ * ever holding up a transfer. */
+static int lat_bucket(uint32_t us)
+{
+    uint32_t q = us / I2C_LAT_BASE_US;
+    if (q == 0) {
+        return 0;
+    }
+    int b = 32 - __builtin_clz(q);          /* 1 + floor(log2(q)) */
+    return b < I2C_LAT_BUCKETS ? b : I2C_LAT_BUCKETS - 1;
+}
+
+static void record(uint8_t addr, bool read, uint32_t bytes, uint32_t txns, int attempts, esp_err_t err, int64_t us)
+{
+    i2c_device_entry_t *e = find_device(addr);
+    if (e == NULL) {
+        return;
+    }
+    uint32_t lat = us > 0 ? (uint32_t)us : 0;
+
+    atomic_fetch_add_explicit(&e->stats_seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    i2c_dev_stats_t *s = &e->stats;
+    s->txns += txns;
+    s->transfers += attempts;
+    s->retries += attempts - 1;
+    if (err == ESP_OK) {
+        if (read) s->bytes_rx += bytes;
+        else s->bytes_tx += bytes;
+    } else {
+        s->errors += txns;
+    }
+    s->busy_us += lat;
+    if (lat > s->lat_max_us) s->lat_max_us = lat;
+    s->lat_hist[lat_bucket(lat)]++;
+    atomic_fetch_add_explicit(&e->stats_seq, 1, memory_order_release);
+}
+
+static void snapshot(i2c_device_entry_t *e, i2c_dev_stats_t *out)
+{
+    uint32_t s0, s1;
+    do {
+        s0 = atomic_load_explicit(&e->stats_seq, memory_order_acquire);
+        memcpy(out, &e->stats, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        s1 = atomic_load_explicit(&e->stats_seq, memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+}
+
+/********************* Bus manager *********************/
+#define I2C_BATCH_MAX   8           /* Transactions merged into one transfer */
+
+typedef struct {
+    i2c_txn_t txn;
+    SemaphoreHandle_t sem;          /* Given on completion for blocking callers, else NULL */
+    esp_err_t *result;
+} i2c_req_t;
+
+static TaskHandle_t s_bus_task = NULL;
+static QueueHandle_t s_queue[I2C_PRIO_COUNT];
+static _Atomic uint32_t s_coalesce_map[4];     /* One bit per 7-bit address */
+
+static inline uint32_t timeout_ms(i2c_prio_t prio)
+{
+    return (prio == I2C_PRIO_HIGH) ? I2C_HIGH_TIMEOUT_MS : I2C_MASTER_TIMEOUT_MS;
+}
+
+static inline bool coalesce_enabled(uint8_t addr)
+{
+    return (atomic_load_explicit(&s_coalesce_map[(addr >> 5) & 3], memory_order_relaxed) >> (addr & 31)) & 1;
+}
+
+_Static_assert(I2C_MAX_SEGMENTS <= I2C_BATCH_MAX, "segment array is sized by I2C_BATCH_MAX");
+
+/**
+ * @brief Register byte and payload segments go out as one transfer straight
+ *        from the callers' buffers: no copy, fixed stack use
+ */
+static esp_err_t exec_write(uint8_t addr, uint8_t reg, const i2c_seg_t *segs, uint32_t count, uint32_t tmo_ms)
+{
+    i2c_master_dev_handle_t dev = get_or_add_device(addr);
+
+    i2c_master_transmit_multi_buffer_info_t info[1 + I2C_BATCH_MAX];
+    size_t n = 0;
+    info[n].write_buffer = &reg;
+    info[n].buffer_size = 1;
+    n++;
+    for (uint32_t i = 0; i < count && n < 1 + I2C_BATCH_MAX; i++) {
+        if (segs[i].len > 0 && segs[i].data != NULL) {
+            info[n].write_buffer = (uint8_t *)segs[i].data;
+            info[n].buffer_size = segs[i].len;
+            n++;
+        }
+    }
+
+    return i2c_master_multi_buffer_transmit(dev, info, n, tmo_ms);
+}
+
+static esp_err_t exec_read(uint8_t addr, uint8_t reg, uint8_t *data, uint32_t len, uint32_t tmo_ms)
+{
+    i2c_master_dev_handle_t dev = get_or_add_device(addr);
+
+    return i2c_master_transmit_receive(dev, &reg, 1, data, len, tmo_ms);
+}
+
+static inline esp_err_t exec_txn(const i2c_txn_t *txn, uint32_t tmo_ms)
+{
+    if (txn->read) {
+        return exec_read(txn->addr, txn->reg, txn->data, txn->len, tmo_ms);
+    }
+    if (txn->n_segs > 0) {
+        return exec_write(txn->addr, txn->reg, txn->segs, txn->n_segs, tmo_ms);
+    }
+    const i2c_seg_t one = { .data = txn->data, .len = txn->len };
+    return exec_write(txn->addr, txn->reg, &one, 1, tmo_ms);
+}
+
+static inline int max_attempts(i2c_prio_t prio)
+{
+    return (prio == I2C_PRIO_HIGH) ? 1 : 1 + I2C_RETRIES;
+}
+
+static uint32_t payload_len(const i2c_txn_t *txn)
+{
+    if (txn->read || txn->n_segs == 0) {
+        return txn->len;
+    }
+    uint32_t len = 0;
+    for (int i = 0; i < txn->n_segs; i++) {
+        len += txn->segs[i].len;
+    }
+    return len;
+}
+
+/**
+ * @brief Run one request with retries and record it in the device's stats
+ */
+static esp_err_t run_txn(const i2c_txn_t *txn, i2c_prio_t prio)
+{
+    int attempts = 0;
+    esp_err_t err;
+    int64_t t0 = esp_timer_get_time();
+    do {
+        err = exec_txn(txn, timeout_ms(prio));
+        attempts++;
+    } while (err != ESP_OK && attempts < max_attempts(prio));
+    record(txn->addr, txn->read, payload_len(txn), 1, attempts, err, esp_timer_get_time() - t0);
+    return err;
+}
+
+static void complete(const i2c_req_t *req, esp_err_t err)
+{
+    if (req->result) {
+        *req->result = err;
+    }
+    if (req->txn.done) {
+        req->txn.done(err, req->txn.arg);
+    }
+    if (req->sem) {
+        xSemaphoreGive(req->sem);
+    }
+}
+
+/**
+ * @brief Can `next` continue the transfer started by `first` (total bytes so far)?
+ */
+static bool can_merge(const i2c_txn_t *first, uint32_t total, const i2c_txn_t *next)
+{
+    return next->addr == first->addr &&
+           next->read == first->read &&
+           next->n_segs == 0 &&
+           next->len > 0 &&
+           (uint32_t)next->reg == first->reg + total &&
+           total + next->len <= I2C_COALESCE_MAX;
+}
+
+/**
+ * @brief Run the oldest transaction at this priority, merged with any queued
+ *        continuations of it (same device, same direction, next register)
+ */
+static void run_batch(i2c_prio_t prio)
+{
+    i2c_req_t batch[I2C_BATCH_MAX];
+    if (xQueueReceive(s_queue[prio], &batch[0], 0) != pdTRUE) {
+        return;
+    }
+
+    int n = 1;
+    uint32_t total = batch[0].txn.len;
+    if (total > 0 && batch[0].txn.n_segs == 0 && coalesce_enabled(batch[0].txn.addr)) {
+        i2c_req_t next;
+        while (n < I2C_BATCH_MAX &&
+               xQueuePeek(s_queue[prio], &next, 0) == pdTRUE &&
+               can_merge(&batch[0].txn, total, &next.txn)) {
+            xQueueReceive(s_queue[prio], &batch[n], 0);
+            total += batch[n].txn.len;
+            n++;
+        }
+    }
+
+    esp_err_t err;
+    if (n == 1) {
+        err = run_txn(&batch[0].txn, prio);
+    } else {
+        const i2c_txn_t *first = &batch[0].txn;
+        uint8_t buf[I2C_COALESCE_MAX];
+        i2c_seg_t segs[I2C_BATCH_MAX];
+        if (!first->read) {
+            /* Each merged write becomes one segment of a single transfer */
+            for (int i = 0; i < n; i++) {
+                segs[i].data = batch[i].txn.data;
+                segs[i].len = batch[i].txn.len;
+            }
+        }
+        int attempts = 0;
+        int64_t t0 = esp_timer_get_time();
+        do {
+            err = first->read ? exec_read(first->addr, first->reg, buf, total, timeout_ms(prio))
+                              : exec_write(first->addr, first->reg, segs, n, timeout_ms(prio));
+            attempts++;
+        } while (err != ESP_OK && attempts < max_attempts(prio));
+        record(first->addr, first->read, total, n, attempts, err, esp_timer_get_time() - t0);
+
+        uint32_t off = 0;
+        for (int i = 0; i < n && first->read && err == ESP_OK; i++) {
+            memcpy(batch[i].txn.data, &buf[off], batch[i].txn.len);
+            off += batch[i].txn.len;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        complete(&batch[i], err);
+    }
+}
+
+/**
+ * @brief Owns the bus: always serves the highest non-empty priority first,
+ *        re-checking after every transfer
+ */
+static void bus_task_fn(void *arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (;;) {
+            int prio = 0;
+            while (prio < I2C_PRIO_COUNT && uxQueueMessagesWaiting(s_queue[prio]) == 0) {
+                prio++;
+            }
+            if (prio == I2C_PRIO_COUNT) {
+                break;
+            }
+            run_batch((i2c_prio_t)prio);
+        }
+    }
+}
+
+static esp_err_t enqueue(const i2c_req_t *req, i2c_prio_t prio, TickType_t wait)
+{
+    if (xQueueSend(s_queue[prio], req, wait) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    xTaskNotifyGive(s_bus_task);
+    return ESP_OK;
+}
+
+/**
+ * @brief Blocking transfer through the bus task (or directly before it
+ *        exists, and from its own callbacks)
+ */
+static esp_err_t transfer(const i2c_txn_t *txn, i2c_prio_t prio)
+{
+    if (prio >= I2C_PRIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_bus_task == NULL || xTaskGetCurrentTaskHandle() == s_bus_task) {
+        return run_txn(txn, prio);
+    }
+
+    StaticSemaphore_t sem_buf;
+    esp_err_t result = ESP_FAIL;
+    i2c_req_t req = {
+        .txn = *txn,
+        .sem = xSemaphoreCreateBinaryStatic(&sem_buf),
+        .result = &result,
+    };
+    esp_err_t ret = enqueue(&req, prio, portMAX_DELAY);
+    if (ret == ESP_OK) {
+        /* The bus timeout bounds how long this can take */
+        xSemaphoreTake(req.sem, portMAX_DELAY);
+        ret = result;
+    }
+    vSemaphoreDelete(req.sem);
+    return ret;
+}
+
 /**
  * @brief I2C master bus initialization (new i2c_master driver)
  */
@@ -63,26 +384,151 @@ void I2C_Init(void)
     };
 
     ESP_ERROR_CHECK(i2c_new_master_bus(&bus_config, &i2c_bus_handle));
+
+    for (int i = 0; i < I2C_PRIO_COUNT; i++) {
+        s_queue[i] = xQueueCreate(I2C_BUS_QUEUE_LEN, sizeof(i2c_req_t));
+        assert(s_queue[i]);
+    }
+    xTaskCreatePinnedToCore(bus_task_fn, "i2c_bus", I2C_BUS_TASK_STACK, NULL, I2C_BUS_TASK_PRIORITY, &s_bus_task, 0);
     ESP_LOGI(I2C_TAG, "I2C initialized successfully");
 }
 
 // Reg addr is 8 bit
 esp_err_t I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length)
 {
-    i2c_master_dev_handle_t dev = get_or_add_device(Driver_addr);
+    return I2C_Write_Prio(Driver_addr, Reg_addr, Reg_data, Length, I2C_PRIO_NORMAL);
+}
+
+esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length)
+{
+    return I2C_Read_Prio(Driver_addr, Reg_addr, Reg_data, Length, I2C_PRIO_NORMAL);
+}
+
+esp_err_t I2C_Write_Prio(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length, i2c_prio_t Prio)
+{
+    const i2c_txn_t txn = {
+        .addr = Driver_addr,
+        .reg = Reg_addr,
+        .read = false,
+        .data = (uint8_t *)Reg_data,
+        .len = Length,
+    };
+    return transfer(&txn, Prio);
+}
+
+esp_err_t I2C_Read_Prio(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length, i2c_prio_t Prio)
+{
+    const i2c_txn_t txn = {
+        .addr = Driver_addr,
+        .reg = Reg_addr,
+        .read = true,
+        .data = Reg_data,
+        .len = Length,
+    };
+    return transfer(&txn, Prio);
+}
 
-    uint8_t buf[Length + 1];
-    buf[0] = Reg_addr;
-    if (Length > 0 && Reg_data != NULL) {
-        memcpy(&buf[1], Reg_data, Length);
+esp_err_t I2C_Write_Segs(uint8_t Driver_addr, uint8_t Reg_addr, const i2c_seg_t *Segs, uint32_t Count, i2c_prio_t Prio)
+{
+    if (Segs == NULL || Count == 0 || Count > I2C_MAX_SEGMENTS) {
+        return ESP_ERR_INVALID_ARG;
     }
+    const i2c_txn_t txn = {
+        .addr = Driver_addr,
+        .reg = Reg_addr,
+        .read = false,
+        .segs = Segs,
+        .n_segs = (uint8_t)Count,
+    };
+    return transfer(&txn, Prio);
+}
 
-    return i2c_master_transmit(dev, buf, Length + 1, I2C_MASTER_TIMEOUT_MS);
+esp_err_t I2C_Submit(const i2c_txn_t *txn, i2c_prio_t Prio)
+{
+    if (txn == NULL || Prio >= I2C_PRIO_COUNT || s_bus_task == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const i2c_req_t req = { .txn = *txn };
+    return enqueue(&req, Prio, 0);
 }
 
-esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length)
+void I2C_Set_Coalesce(uint8_t Driver_addr, bool Enable)
+{
+    uint32_t bit = 1u << (Driver_addr & 31);
+    if (Enable) {
+        atomic_fetch_or(&s_coalesce_map[(Driver_addr >> 5) & 3], bit);
+    } else {
+        atomic_fetch_and(&s_coalesce_map[(Driver_addr >> 5) & 3], ~bit);
+    }
+}
+
+int I2C_Get_Stats(i2c_dev_stats_t *Stats, int Max)
+{
+    int count = atomic_load_explicit(&device_count, memory_order_acquire);
+    int n = 0;
+    for (int i = 0; i < count && n < Max; i++) {
+        snapshot(&device_cache[i], &Stats[n++]);
+    }
+    return n;
+}
+
+bool I2C_Get_Device_Stats(uint8_t Driver_addr, i2c_dev_stats_t *Stats)
 {
+    i2c_device_entry_t *e = find_device(Driver_addr);
+    if (e == NULL) {
+        return false;
+    }
+    snapshot(e, Stats);
+    return true;
+}
+
+uint32_t I2C_Lat_Bucket_Limit_Us(int Bucket)
+{
+    if (Bucket < 0 || Bucket >= I2C_LAT_BUCKETS - 1) {
+        return 0;
+    }
+    return (uint32_t)I2C_LAT_BASE_US << Bucket;
+}
+
+#if I2C_BENCH
+/********************* Write path benchmark *********************/
+#define BENCH_ROUNDS    200
+
+/* The pre-scatter/gather write: VLA on the stack plus a payload copy */
+static esp_err_t bench_copy_write(i2c_master_dev_handle_t dev, uint8_t reg, const uint8_t *data, uint32_t len)
+{
+    uint8_t buf[len + 1];
+    buf[0] = reg;
+    memcpy(&buf[1], data, len);
+    return i2c_master_transmit(dev, buf, len + 1, I2C_MASTER_TIMEOUT_MS);
+}
+
+void I2C_Bench(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t Value)
+{
+    static const uint32_t sizes[] = { 1, 4, 16, 32 };
+    uint8_t payload[32];
+    memset(payload, Value, sizeof(payload));
     i2c_master_dev_handle_t dev = get_or_add_device(Driver_addr);
 
-    return i2c_master_transmit_receive(dev, &Reg_addr, 1, Reg_data, Length, I2C_MASTER_TIMEOUT_MS);
+    ESP_LOGI(I2C_TAG, "Bench 0x%02X reg 0x%02X, %d rounds: len, path, us/txn, payload B/s, cycles/txn", Driver_addr, Reg_addr, BENCH_ROUNDS);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t len = sizes[s];
+        for (int path = 0; path < 2; path++) {
+            const i2c_seg_t seg = { .data = payload, .len = len };
+            int fails = 0;
+            int64_t t0 = esp_timer_get_time();
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            for (int r = 0; r < BENCH_ROUNDS; r++) {
+                esp_err_t err = path ? exec_write(Driver_addr, Reg_addr, &seg, 1, I2C_MASTER_TIMEOUT_MS)
+                                     : bench_copy_write(dev, Reg_addr, payload, len);
+                fails += (err != ESP_OK);
+            }
+            uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+            int64_t us = esp_timer_get_time() - t0;
+            ESP_LOGI(I2C_TAG, "%2lu  %-4s  %5lld  %7lld  %7lu%s", (unsigned long)len, path ? "segs" : "copy",
+                     (long long)(us / BENCH_ROUNDS), us > 0 ? (long long)len * BENCH_ROUNDS * 1000000 / us : 0LL,
+                     (unsigned long)(cycles / BENCH_ROUNDS), fails ? "  (errors)" : "");
+        }
+    }
 }
+#endif
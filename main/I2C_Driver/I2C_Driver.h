@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>  // For memcpy
 #include "esp_log.h"
@@ -14,10 +15,88 @@
 #define I2C_MASTER_FREQ_HZ          400000    /*!< I2C master clock frequency */
 #define I2C_MASTER_TIMEOUT_MS       1000
 
+/********************* Bus manager *********************/
+/* One task owns the bus and runs every transaction, so callers never
+ * contend for it and a queued touch read is always taken before queued
+ * RTC / IMU / EXIO traffic. */
+#define I2C_BUS_TASK_PRIORITY       6
+#define I2C_BUS_TASK_STACK          3072
+#define I2C_BUS_QUEUE_LEN           8         /*!< Pending transactions per priority level */
+#define I2C_COALESCE_MAX            32        /*!< Largest merged transfer (register bytes); bounds how long a HIGH request can wait */
+#define I2C_HIGH_TIMEOUT_MS         50        /*!< Bus timeout for HIGH priority (touch) transfers */
+#define I2C_MAX_SEGMENTS            4         /*!< Payload segments per scatter/gather write */
+#define I2C_RETRIES                 1         /*!< Extra attempts after a failed NORMAL/LOW transfer (HIGH never retries) */
+#define I2C_LAT_BUCKETS             8         /*!< Latency histogram: <50 us, <100, <200, ... doubling, last bucket open-ended */
+#define I2C_LAT_BASE_US             50
+#define I2C_BENCH                   0         /*!< 1 = time the write path at boot (I2C_Bench from EXIO_Init) */
+
+typedef enum {
+    I2C_PRIO_HIGH = 0,                        /*!< Touch: latency visible to the user */
+    I2C_PRIO_NORMAL,                          /*!< Default for I2C_Read / I2C_Write */
+    I2C_PRIO_LOW,                             /*!< Background (RTC polling, IMU) */
+    I2C_PRIO_COUNT
+} i2c_prio_t;
+
+/** One piece of a scatter/gather write payload, sent in place (no copy) */
+typedef struct {
+    const uint8_t *data;
+    uint32_t len;
+} i2c_seg_t;
+
+/** Completion callback, runs in the bus task: keep it short and do not block */
+typedef void (*i2c_done_cb_t)(esp_err_t err, void *arg);
+
+typedef struct {
+    uint8_t addr;                             /*!< 7-bit device address */
+    uint8_t reg;                              /*!< First register */
+    bool read;                                /*!< true = read Length bytes into data, false = write them */
+    uint8_t *data;                            /*!< Caller-owned, must stay valid until done runs */
+    uint32_t len;
+    const i2c_seg_t *segs;                    /*!< Write only: if n_segs > 0, payload is these segments instead of data/len */
+    uint8_t n_segs;                           /*!< 0..I2C_MAX_SEGMENTS */
+    i2c_done_cb_t done;                       /*!< Optional */
+    void *arg;
+} i2c_txn_t;
+
+/** Per-device bus statistics, accumulated since boot by the bus task */
+typedef struct {
+    uint8_t addr;
+    uint32_t txns;                            /*!< Requests completed (merged ones count individually) */
+    uint32_t transfers;                       /*!< Bus transfers, retries included */
+    uint32_t bytes_tx;                        /*!< Payload bytes written (register byte excluded) */
+    uint32_t bytes_rx;
+    uint32_t errors;                          /*!< Requests that failed after retries */
+    uint32_t retries;
+    uint32_t lat_max_us;
+    uint64_t busy_us;                         /*!< Total time spent in transfers */
+    uint32_t lat_hist[I2C_LAT_BUCKETS];       /*!< Per-request latency, retries included */
+} i2c_dev_stats_t;
+
 /* Global I2C bus handle - exposed for esp_lcd_panel_io_i2c and similar APIs */
 extern i2c_master_bus_handle_t i2c_bus_handle;
 
 void I2C_Init(void);
 // Reg addr is 8 bit
 esp_err_t I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length);
-esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length);
\ No newline at end of file
+esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length);
+// Blocking, at a given priority
+esp_err_t I2C_Write_Prio(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length, i2c_prio_t Prio);
+esp_err_t I2C_Read_Prio(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length, i2c_prio_t Prio);
+// Scatter/gather write: register byte then each segment, sent in place with no copy or stack buffer
+esp_err_t I2C_Write_Segs(uint8_t Driver_addr, uint8_t Reg_addr, const i2c_seg_t *Segs, uint32_t Count, i2c_prio_t Prio);
+// Queue a transaction and return; txn->done reports the result. ESP_ERR_TIMEOUT if the queue is full
+esp_err_t I2C_Submit(const i2c_txn_t *txn, i2c_prio_t Prio);
+// Allow back-to-back transactions to Driver_addr at consecutive registers to be merged into one
+// transfer. Only for devices that auto-increment the register address (PCF85063, QMI8658 with ADDR_AI)
+void I2C_Set_Coalesce(uint8_t Driver_addr, bool Enable);
+// Consistent snapshot of every device's statistics, lock-free (never blocks the bus). Returns the number filled
+int I2C_Get_Stats(i2c_dev_stats_t *Stats, int Max);
+// Snapshot for one address; false if the device has not been used
+bool I2C_Get_Device_Stats(uint8_t Driver_addr, i2c_dev_stats_t *Stats);
+// Upper bound (us) of histogram bucket Bucket, 0 for the open-ended last bucket
+uint32_t I2C_Lat_Bucket_Limit_Us(int Bucket);
+#if I2C_BENCH
+// Write Value repeatedly to Reg_addr of an idle device that does not auto-increment (e.g. TCA9554 output,
+// rewriting its current level) through the old copy path and the segment path, and log throughput and cycles
+void I2C_Bench(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t Value);
+#endif
\ No newline at end of file
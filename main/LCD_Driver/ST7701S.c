@@ -1,9 +1,13 @@
 #include "ST7701S.h"
+#include <string.h>
+#include "esp_timer.h"
 
 #define SPI_WriteComm(cmd) ST7701S_WriteCommand(St7701S_handle, cmd)
 #define SPI_WriteData(data) ST7701S_WriteData(St7701S_handle, data)
 #define Delay(ms) vTaskDelay(ms / portTICK_PERIOD_MS)
 
+#define ST7701S_PACKED_MAX  (((1 + 16) * 9 + 7) / 8)    // Longest command + 16 parameters, 9 bits each
+
 static const char *LCD_TAG = "LCD";
 
 void ioexpander_init(){};
@@ -32,7 +36,7 @@ ST7701S_handle ST7701S_newObject(int SDA, int SCL, int CS, char channel_select,
         st7701s_handle->spi_io_config_t.quadwp_io_num = -1;
         st7701s_handle->spi_io_config_t.quadhd_io_num = -1;
 
-        st7701s_handle->spi_io_config_t.max_transfer_sz = SOC_SPI_MAXIMUM_BUFFER_SIZE;
+        st7701s_handle->spi_io_config_t.max_transfer_sz = ST7701S_PACKED_MAX;
 
         ESP_ERROR_CHECK(spi_bus_initialize(channel_select, &(st7701s_handle->spi_io_config_t),SPI_DMA_CH_AUTO));
 
@@ -41,7 +45,9 @@ ST7701S_handle ST7701S_newObject(int SDA, int SCL, int CS, char channel_select,
         st7701s_handle->st7701s_protocol_config_t.clock_speed_hz = 4000000;
         st7701s_handle->st7701s_protocol_config_t.mode = 0;
         st7701s_handle->st7701s_protocol_config_t.spics_io_num = CS;
-        st7701s_handle->st7701s_protocol_config_t.queue_size = 1;
+        st7701s_handle->st7701s_protocol_config_t.queue_size = ST7701S_QUEUE_SIZE;
+        // SDA is bidirectional: half-duplex 3-wire lets ST7701S_Verify() read registers back
+        st7701s_handle->st7701s_protocol_config_t.flags = SPI_DEVICE_3WIRE | SPI_DEVICE_HALFDUPLEX;
 
         ESP_ERROR_CHECK(spi_bus_add_device(channel_select, &(st7701s_handle->st7701s_protocol_config_t),
                                         &(st7701s_handle->spi_device)));
@@ -53,6 +59,127 @@ ST7701S_handle ST7701S_newObject(int SDA, int SCL, int CS, char channel_select,
     return NULL;
 }
 
+/***********************
+ *  INIT SEQUENCE
+ *  One entry per command: parameters, parameter count, and a delay after
+ *  it. Streamed by send_cmds() as queued DMA transactions instead of one
+ *  polled transaction per byte.
+ ***********************/
+typedef struct {
+    uint8_t cmd;
+    uint8_t data[16];
+    uint8_t len;
+    uint16_t delay_ms;
+} st7701s_init_cmd_t;
+
+static const st7701s_init_cmd_t st7701s_init_2_1inch[] = {
+    { 0xFF, { 0x77, 0x01, 0x00, 0x00, 0x10 }, 5, 0 },   // Command2 BK0
+    { 0xC0, { 0x3B, 0x00 }, 2, 0 },                     // Scan line
+    { 0xC1, { 0x0B, 0x02 }, 2, 0 },                     // VBP
+    { 0xC2, { 0x07, 0x02 }, 2, 0 },
+    { 0xCC, { 0x10 }, 1, 0 },
+    { 0xCD, { 0x08 }, 1, 0 },                           // RGB format
+    { 0xB0, { 0x00, 0x11, 0x16, 0x0E, 0x11, 0x06, 0x05, 0x09, 0x08, 0x21, 0x06, 0x13, 0x10, 0x29, 0x31, 0x18 }, 16, 0 }, // Positive gamma (IPS)
+    { 0xB1, { 0x00, 0x11, 0x16, 0x0E, 0x11, 0x07, 0x05, 0x09, 0x09, 0x21, 0x05, 0x13, 0x11, 0x2A, 0x31, 0x18 }, 16, 0 }, // Negative gamma (IPS)
+    { 0xFF, { 0x77, 0x01, 0x00, 0x00, 0x11 }, 5, 0 },   // Command2 BK1
+    { 0xB0, { 0x6D }, 1, 0 },                           // VOP 3.5375 + x * 0.0125
+    { 0xB1, { 0x37 }, 1, 0 },                           // VCOM amplitude
+    { 0xB2, { 0x81 }, 1, 0 },                           // VGH 12 V
+    { 0xB3, { 0x80 }, 1, 0 },
+    { 0xB5, { 0x43 }, 1, 0 },                           // VGL -8.3 V
+    { 0xB7, { 0x85 }, 1, 0 },
+    { 0xB8, { 0x20 }, 1, 0 },
+    { 0xC1, { 0x78 }, 1, 0 },
+    { 0xC2, { 0x78 }, 1, 0 },
+    { 0xD0, { 0x88 }, 1, 0 },
+    { 0xE0, { 0x00, 0x00, 0x02 }, 3, 0 },
+    { 0xE1, { 0x03, 0xA0, 0x00, 0x00, 0x04, 0xA0, 0x00, 0x00, 0x00, 0x20, 0x20 }, 11, 0 },
+    { 0xE2, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 13, 0 },
+    { 0xE3, { 0x00, 0x00, 0x11, 0x00 }, 4, 0 },
+    { 0xE4, { 0x22, 0x00 }, 2, 0 },
+    { 0xE5, { 0x05, 0xEC, 0xA0, 0xA0, 0x07, 0xEE, 0xA0, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 16, 0 },
+    { 0xE6, { 0x00, 0x00, 0x11, 0x00 }, 4, 0 },
+    { 0xE7, { 0x22, 0x00 }, 2, 0 },
+    { 0xE8, { 0x06, 0xED, 0xA0, 0xA0, 0x08, 0xEF, 0xA0, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 16, 0 },
+    { 0xEB, { 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x00 }, 7, 0 },
+    { 0xED, { 0xFF, 0xFF, 0xFF, 0xBA, 0x0A, 0xBF, 0x45, 0xFF, 0xFF, 0x54, 0xFB, 0xA0, 0xAB, 0xFF, 0xFF, 0xFF }, 16, 0 },
+    { 0xEF, { 0x10, 0x0D, 0x04, 0x08, 0x3F, 0x1F }, 6, 0 },
+    { 0xFF, { 0x77, 0x01, 0x00, 0x00, 0x13 }, 5, 0 },   // Command2 BK3
+    { 0xEF, { 0x08 }, 1, 0 },
+    { 0xFF, { 0x77, 0x01, 0x00, 0x00, 0x00 }, 5, 0 },   // Command2 off
+    { 0x36, { 0x00 }, 1, 0 },                           // MADCTL
+    { 0x3A, { 0x66 }, 1, 0 },                           // COLMOD 18-bit
+    { 0x11, { 0 }, 0, 480 },                            // Sleep out
+    { 0x20, { 0 }, 0, 120 },                            // Inversion off
+    { 0x29, { 0 }, 0, 0 },                              // Display on
+};
+
+/* 3-wire SPI sends every byte as 9 bits: D/C (0 = command, 1 = data) then
+ * the byte, MSB first. The whole command with its parameters is packed into
+ * one bit stream and sent as a single transaction. */
+static size_t pack_cmd(uint8_t *buf, const st7701s_init_cmd_t *c)
+{
+    memset(buf, 0, ST7701S_PACKED_MAX);
+    size_t bit = 0;
+    for (int i = -1; i < c->len; i++) {
+        uint16_t word = (i < 0) ? c->cmd : (0x100 | c->data[i]);
+        for (int b = 8; b >= 0; b--, bit++) {
+            if (word & (1u << b)) {
+                buf[bit / 8] |= 0x80 >> (bit % 8);
+            }
+        }
+    }
+    return bit;
+}
+
+/**
+ * @brief Stream a command table. Up to ST7701S_QUEUE_SIZE transactions are
+ *        in flight; the queue is drained only before a delay and at the end.
+*/
+static esp_err_t send_cmds(ST7701S_handle St7701S_handle, const st7701s_init_cmd_t *cmds, size_t count, bool with_delays)
+{
+    static spi_transaction_ext_t trans[ST7701S_QUEUE_SIZE];
+    static uint8_t tx[ST7701S_QUEUE_SIZE][ST7701S_PACKED_MAX];   // .bss: internal RAM, DMA capable
+    spi_transaction_t *done;
+    int inflight = 0;
+    int slot = 0;
+    esp_err_t ret = ESP_OK;
+
+    for (size_t i = 0; i < count && ret == ESP_OK; i++) {
+        if (inflight == ST7701S_QUEUE_SIZE) {
+            // Oldest transaction, which is the slot about to be reused
+            ret = spi_device_get_trans_result(St7701S_handle->spi_device, &done, portMAX_DELAY);
+            inflight--;
+        }
+        trans[slot] = (spi_transaction_ext_t) {
+            .base = {
+                .flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR,
+                .length = pack_cmd(tx[slot], &cmds[i]),
+                .tx_buffer = tx[slot],
+            },
+            .command_bits = 0,
+            .address_bits = 0,
+        };
+        if (ret == ESP_OK) {
+            ret = spi_device_queue_trans(St7701S_handle->spi_device, &trans[slot].base, portMAX_DELAY);
+        }
+        if (ret == ESP_OK) {
+            inflight++;
+            slot = (slot + 1) % ST7701S_QUEUE_SIZE;
+        }
+        if (with_delays && cmds[i].delay_ms) {
+            for (; inflight > 0; inflight--) {
+                spi_device_get_trans_result(St7701S_handle->spi_device, &done, portMAX_DELAY);
+            }
+            Delay(cmds[i].delay_ms);
+        }
+    }
+    for (; inflight > 0; inflight--) {
+        spi_device_get_trans_result(St7701S_handle->spi_device, &done, portMAX_DELAY);
+    }
+    return ret;
+}
+
 /**
  * @brief Screen initialization
  * @param St7701S_handle 
@@ -63,261 +190,81 @@ void ST7701S_screen_init(ST7701S_handle St7701S_handle, unsigned char type)
 {
     if (type == 1){
     // 2.1inch
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x10);
-
-    SPI_WriteComm(0xC0);
-    SPI_WriteData(0x3B);//Scan line	
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xC1);
-    SPI_WriteData(0x0B);	//VBP
-    SPI_WriteData(0x02);
-
-    SPI_WriteComm(0xC2);
-    SPI_WriteData(0x07);
-    SPI_WriteData(0x02);
-
-    SPI_WriteComm(0xCC);
-    SPI_WriteData(0x10);
-
-    SPI_WriteComm(0xCD);//RGB format
-    SPI_WriteData(0x08);
-
-    SPI_WriteComm(0xB0); // IPS   
-    SPI_WriteData(0x00); // 255 
-    SPI_WriteData(0x11); // 251    
-    SPI_WriteData(0x16); // 247  down
-    SPI_WriteData(0x0e); // 239    
-    SPI_WriteData(0x11); // 231    
-    SPI_WriteData(0x06); // 203    
-    SPI_WriteData(0x05); // 175 
-    SPI_WriteData(0x09); // 147    
-    SPI_WriteData(0x08); // 108    
-    SPI_WriteData(0x21); // 80  
-    SPI_WriteData(0x06); // 52   
-    SPI_WriteData(0x13); // 24    
-    SPI_WriteData(0x10); // 16    
-    SPI_WriteData(0x29); // 8    down
-    SPI_WriteData(0x31); // 4    
-    SPI_WriteData(0x18); // 0   
-
-    SPI_WriteComm(0xB1);//  IPS	   
-    SPI_WriteData(0x00);//  255 
-    SPI_WriteData(0x11);//  251
-    SPI_WriteData(0x16);//  247   down
-    SPI_WriteData(0x0e);//  239
-    SPI_WriteData(0x11);//  231
-    SPI_WriteData(0x07);//  203    
-    SPI_WriteData(0x05);//  175
-    SPI_WriteData(0x09);//  147  
-    SPI_WriteData(0x09);//  108  
-    SPI_WriteData(0x21);//  80 
-    SPI_WriteData(0x05);//  52   
-    SPI_WriteData(0x13);//  24 
-    SPI_WriteData(0x11);//  16 
-    SPI_WriteData(0x2a);//  8  down 
-    SPI_WriteData(0x31);//  4  
-    SPI_WriteData(0x18);//  0  
-
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-
-    SPI_WriteComm(0xB0);  //VOP  3.5375+ *x 0.0125
-    SPI_WriteData(0x6d);  //5D
-    
-    SPI_WriteComm(0xB1); 	//VCOM amplitude setting  
-    SPI_WriteData(0x37);  //
-    
-    SPI_WriteComm(0xB2); 	//VGH Voltage setting  
-    SPI_WriteData(0x81);	//12V
-
-    SPI_WriteComm(0xB3);
-    SPI_WriteData(0x80);
-
-    SPI_WriteComm(0xB5); 	//VGL Voltage setting  
-    SPI_WriteData(0x43);	//-8.3V
-
-    SPI_WriteComm(0xB7);
-    SPI_WriteData(0x85);
-
-    SPI_WriteComm(0xB8);
-    SPI_WriteData(0x20);
-
-    SPI_WriteComm(0xC1);
-    SPI_WriteData(0x78);
-
-    SPI_WriteComm(0xC2);
-    SPI_WriteData(0x78);
-
-    SPI_WriteComm(0xD0);
-    SPI_WriteData(0x88);
-
-    SPI_WriteComm(0xE0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x02);
-
-    SPI_WriteComm(0xE1);
-    SPI_WriteData(0x03);	
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x04);	
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x20);
-    SPI_WriteData(0x20);
-
-    SPI_WriteComm(0xE2);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	  
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE3);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE4);
-    SPI_WriteData(0x22);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE5);		
-    SPI_WriteData(0x05);	
-    SPI_WriteData(0xEC);	
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x07);	
-    SPI_WriteData(0xEE);	
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE6);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE7);
-    SPI_WriteData(0x22);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE8);		
-    SPI_WriteData(0x06);	
-    SPI_WriteData(0xED);	
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x08);	
-    SPI_WriteData(0xEF);	
-    SPI_WriteData(0xA0); 
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xEB);
-    SPI_WriteData(0x00); 	
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x40);
-    SPI_WriteData(0x40);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);  
-
-    SPI_WriteComm(0xED);  
-    SPI_WriteData(0xFF); 
-    SPI_WriteData(0xFF);  
-    SPI_WriteData(0xFF); 	
-    SPI_WriteData(0xBA); 		
-    SPI_WriteData(0x0A); 	
-    SPI_WriteData(0xBF); 	
-    SPI_WriteData(0x45); 	
-    SPI_WriteData(0xFF); 
-    SPI_WriteData(0xFF);  
-    SPI_WriteData(0x54); 	
-    SPI_WriteData(0xFB); 	
-    SPI_WriteData(0xA0); 	
-    SPI_WriteData(0xAB); 	
-    SPI_WriteData(0xFF); 
-    SPI_WriteData(0xFF); 
-    SPI_WriteData(0xFF); 
-
-    SPI_WriteComm(0xEF);
-    SPI_WriteData(0x10); 
-    SPI_WriteData(0x0D); 
-    SPI_WriteData(0x04); 
-    SPI_WriteData(0x08); 
-    SPI_WriteData(0x3F); 
-    SPI_WriteData(0x1F);
-
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x13);
-
-    SPI_WriteComm(0xEF);
-    SPI_WriteData(0x08);
-
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-
-
-    SPI_WriteComm(0x36);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0x3A);
-    SPI_WriteData(0x66);
-
-    SPI_WriteComm(0x11);
-    Delay(480); 
-
-    SPI_WriteComm(0x20); //
-    Delay (120);
-    SPI_WriteComm(0x29); 
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t ret = send_cmds(St7701S_handle, st7701s_init_2_1inch,
+                              sizeof(st7701s_init_2_1inch) / sizeof(st7701s_init_2_1inch[0]), true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(LCD_TAG, "Init sequence failed: %s", esp_err_to_name(ret));
+    }
+    ESP_LOGI(LCD_TAG, "Init sequence sent in %lld ms", (long long)(esp_timer_get_time() - t0) / 1000);
+    }
+}
+
+/**
+ * @brief Read one 8-bit register (3-wire: the panel drives SDA after the command)
+*/
+static esp_err_t read_reg(ST7701S_handle St7701S_handle, uint8_t reg, uint8_t *value)
+{
+    spi_transaction_t spi_tran = {
+        .flags = SPI_TRANS_USE_RXDATA,
+        .cmd = 0,
+        .addr = reg,
+        .length = 0,
+        .rxlength = 8,
+    };
+    esp_err_t ret = spi_device_transmit(St7701S_handle->spi_device, &spi_tran);
+    *value = spi_tran.rx_data[0];
+    return ret;
+}
+
+bool ST7701S_Verify(ST7701S_handle St7701S_handle)
+{
+    /* Registers the init sequence leaves in a known state */
+    static const struct { uint8_t reg; uint8_t expect; uint8_t mask; const char *name; } checks[] = {
+        { 0x0A, 0x14, 0x14, "RDDPM" },      // Sleep out + display on
+        { 0x0B, 0x00, 0xFF, "RDDMADCTL" },  // MADCTL 0x00
+        { 0x0C, 0x66, 0x77, "RDDCOLMOD" },  // COLMOD 0x66
+    };
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        uint8_t v = 0;
+        if (read_reg(St7701S_handle, checks[i].reg, &v) != ESP_OK || (v & checks[i].mask) != checks[i].expect) {
+            ESP_LOGW(LCD_TAG, "%s = 0x%02X, expected 0x%02X: panel not latched", checks[i].name, v, checks[i].expect);
+            return false;
+        }
     }
+    return true;
 }
 
+#if ST7701S_INIT_BENCH
+/**
+ * @brief Send the register part of the sequence (no sleep-out/display-on
+ *        delays) through the per-byte path and the queued path, and log both
+*/
+static void init_bench(ST7701S_handle St7701S_handle)
+{
+    const st7701s_init_cmd_t *cmds = st7701s_init_2_1inch;
+    size_t count = 0;
+    size_t bytes = 0;
+    while (count < sizeof(st7701s_init_2_1inch) / sizeof(st7701s_init_2_1inch[0]) && cmds[count].delay_ms == 0) {
+        bytes += 1 + cmds[count].len;
+        count++;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    for (size_t i = 0; i < count; i++) {
+        SPI_WriteComm(cmds[i].cmd);
+        for (int j = 0; j < cmds[i].len; j++) {
+            SPI_WriteData(cmds[i].data[j]);
+        }
+    }
+    int64_t t1 = esp_timer_get_time();
+    send_cmds(St7701S_handle, cmds, count, false);
+    int64_t t2 = esp_timer_get_time();
+    ESP_LOGI(LCD_TAG, "Init bench: %u commands / %u bytes, per-byte %lld us, queued %lld us",
+             (unsigned)count, (unsigned)bytes, (long long)(t1 - t0), (long long)(t2 - t1));
+}
+#endif
+
 /**
  * @brief Example Delete the ST7701S object
  * @param St7701S_handle 
@@ -421,7 +368,11 @@ void LCD_Init(void)
     /* The ST7701S must receive its full register config via SPI before the
      * RGB panel starts sending pixel clocks. Configure it twice (double-init)
      * for reliability — this is a well-known workaround for ST7701S displays
-     * that sometimes fail to latch SPI config on cold boot. */
+     * that sometimes fail to latch SPI config on cold boot. With
+     * ST7701S_VERIFY_SKIP the repeat passes only run when a register
+     * readback says the previous pass did not latch. */
+    int64_t t_start = esp_timer_get_time();
+    int passes = 1;
 
     ESP_LOGI(LCD_TAG, "=== LCD Init: Pass 1 — initial ST7701S config ===");
     ST7701S_reset();
@@ -429,14 +380,20 @@ void LCD_Init(void)
     vTaskDelay(pdMS_TO_TICKS(10));
 
     st7701s_spi = ST7701S_newObject(LCD_MOSI, LCD_SCLK, LCD_CS, SPI2_HOST, SPI_METHOD);
+#if ST7701S_INIT_BENCH
+    init_bench(st7701s_spi);
+#endif
     ST7701S_screen_init(st7701s_spi, 1);
 
     /* Double-init: reset the ST7701S and send config again.
      * The first pass primes the internal state machine; the second
      * pass ensures all registers are latched correctly. */
-    ESP_LOGI(LCD_TAG, "=== LCD Init: Pass 2 — re-init ST7701S for reliability ===");
-    ST7701S_reset();
-    ST7701S_screen_init(st7701s_spi, 1);
+    if (!ST7701S_VERIFY_SKIP || !ST7701S_Verify(st7701s_spi)) {
+        ESP_LOGI(LCD_TAG, "=== LCD Init: Pass 2 — re-init ST7701S for reliability ===");
+        ST7701S_reset();
+        ST7701S_screen_init(st7701s_spi, 1);
+        passes++;
+    }
     ST7701S_CS_Dis();
 
     /********************* RGB LCD panel driver *********************/
@@ -509,14 +466,18 @@ void LCD_Init(void)
     /* After RGB panel init starts the pixel clock, re-send ST7701S config
      * one final time. Some ST7701S panels need re-configuration after the
      * RGB clock starts to properly sync the display engine. */
-    ESP_LOGI(LCD_TAG, "=== LCD Init: Pass 3 — post-RGB ST7701S re-config ===");
     vTaskDelay(pdMS_TO_TICKS(100));  // Let RGB clock stabilize
     ST7701S_CS_EN();
     vTaskDelay(pdMS_TO_TICKS(10));
-    ST7701S_screen_init(st7701s_spi, 1);
+    if (!ST7701S_VERIFY_SKIP || !ST7701S_Verify(st7701s_spi)) {
+        ESP_LOGI(LCD_TAG, "=== LCD Init: Pass 3 — post-RGB ST7701S re-config ===");
+        ST7701S_screen_init(st7701s_spi, 1);
+        passes++;
+    }
     ST7701S_CS_Dis();
 
-    ESP_LOGI(LCD_TAG, "LCD initialization complete");
+    ESP_LOGI(LCD_TAG, "LCD initialization complete: %d pass(es), %lld ms", passes,
+             (long long)(esp_timer_get_time() - t_start) / 1000);
     Backlight_Init();
 }
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,14 @@
 #define SPI_METHOD 1
 #define IOEXPANDER_METHOD 0
 
+/* The init sequence is a const table streamed as queued DMA transactions.
+ * LCD_Init() used to send it three times (reset + pass, re-init pass,
+ * post-RGB pass); with ST7701S_VERIFY_SKIP a repeat pass only runs when
+ * reading back the panel's status registers shows it did not latch. */
+#define ST7701S_QUEUE_SIZE      8       // SPI transactions in flight
+#define ST7701S_VERIFY_SKIP     1       // 0 = always run all three passes
+#define ST7701S_INIT_BENCH      0       // 1 = time the old per-byte path against the queued one at boot
+
 
 /********************* LCD *********************/
 
@@ -86,6 +94,7 @@ typedef ST7701S * ST7701S_handle;
 ST7701S_handle ST7701S_newObject(int SDA, int SCL, int CS, char channel_select, char method_select);//Create new object
 void ST7701S_screen_init(ST7701S_handle St7701S_handle, unsigned char type);//Screen initialization
 void ST7701S_delObject(ST7701S_handle St7701S_handle);//Delete object
+bool ST7701S_Verify(ST7701S_handle St7701S_handle);//Read back status registers, true if the init sequence latched
 void ST7701S_WriteCommand(ST7701S_handle St7701S_handle, uint8_t cmd);//SPI write instruction
 void ST7701S_WriteData(ST7701S_handle St7701S_handle, uint8_t data);//SPI write data
 esp_err_t ST7701S_CS_EN(void);//Enables SPI CS
@@ -52,11 +52,17 @@ void example_touchpad_read( lv_indev_drv_t * drv, lv_indev_data_t * data )
     uint16_t touchpad_y[1] = {0};
     uint8_t touchpad_cnt = 0;
 
+#if TOUCH_USE_INTERRUPT
+    /* Latest point from the INT-driven touch task: no bus traffic here */
+    bool touchpad_pressed = Touch_Get_Point(&touchpad_x[0], &touchpad_y[0]);
+    touchpad_cnt = touchpad_pressed ? 1 : 0;
+#else
     /* Read touch controller data */
     esp_lcd_touch_read_data(drv->user_data);
 
     /* Get coordinates */
     bool touchpad_pressed = esp_lcd_touch_get_coordinates(drv->user_data, touchpad_x, touchpad_y, NULL, &touchpad_cnt, 1);
+#endif
 
     if (touchpad_pressed && touchpad_cnt > 0) {
         if (touchpad_x[0] < EXAMPLE_LCD_H_RES && touchpad_y[0] < EXAMPLE_LCD_V_RES) {
@@ -2,6 +2,11 @@
 #include "ui_common.h"
 #include "screen_manager.h"
 #include "PCF85063.h"
+#include "Thermistor.h"
+#include "Spray.h"
+
+// Temperature label refresh period (reads the sensor ring, no driver-task lock)
+#define TEMP_REFRESH_MS 250
 
 /***********************
  *  STATIC VARIABLES
@@ -13,11 +18,14 @@ static lv_obj_t *lbl_time = NULL;
 static lv_obj_t *icon_relay_active = NULL;
 static lv_obj_t *icon_tank_empty = NULL;
 static lv_timer_t *update_timer = NULL;
+static lv_timer_t *temp_timer = NULL;
+static int64_t last_temp_timestamp = 0;
 
 /***********************
  *  STATIC PROTOTYPES
  ***********************/
 static void update_timer_cb(lv_timer_t *timer);
+static void temp_timer_cb(lv_timer_t *timer);
 
 /***********************
  *  IMPLEMENTATIONS
@@ -28,6 +36,28 @@ static void update_timer_cb(lv_timer_t *timer)
     screen_main_update_time();
 }
 
+static void temp_timer_cb(lv_timer_t *timer)
+{
+    sensor_sample_t sample;
+    if (!Sensor_Ring_Latest(&sample) || sample.timestamp_us == last_temp_timestamp) {
+        return;
+    }
+    last_temp_timestamp = sample.timestamp_us;
+
+    // Suspect readings keep the last good value on screen; a latched fault replaces it
+    uint32_t flags = sample.flags[THERMISTOR_CONTROL_CHANNEL];
+    switch (Sensor_Health_FromFlags(flags)) {
+        case SENSOR_HEALTH_OK:
+            screen_main_update_temperature(sample.temp_c[THERMISTOR_CONTROL_CHANNEL]);
+            break;
+        case SENSOR_HEALTH_FAULT:
+            screen_main_show_sensor_fault(flags);
+            break;
+        default:
+            break;
+    }
+}
+
 lv_obj_t *screen_main_create(lv_obj_t *parent)
 {
     const ui_fonts_t *fonts = ui_common_get_fonts();
@@ -134,8 +164,15 @@ lv_obj_t *screen_main_create(lv_obj_t *parent)
     // Create timer to update time every 1 second
     update_timer = lv_timer_create(update_timer_cb, 1000, NULL);
 
-    // Initial update
+    // Create timer to pull the newest temperature sample
+    temp_timer = lv_timer_create(temp_timer_cb, TEMP_REFRESH_MS, NULL);
+    last_temp_timestamp = 0;
+
+    // Initial update; indicators start from the engine state, later changes are pushed
     screen_main_update_time();
+    screen_main_set_power_on(Spray_IsEnabled());
+    screen_main_set_tank_empty(Spray_IsTankEmpty());
+    screen_main_set_relay_active(Spray_IsActive());
     
     return container;
 }
@@ -146,6 +183,10 @@ void screen_main_destroy(void)
         lv_timer_del(update_timer);
         update_timer = NULL;
     }
+    if (temp_timer) {
+        lv_timer_del(temp_timer);
+        temp_timer = NULL;
+    }
     
     if (container) {
         lv_obj_del(container);
@@ -165,6 +206,9 @@ void screen_main_show(void)
     if (update_timer) {
         lv_timer_resume(update_timer);
     }
+    if (temp_timer) {
+        lv_timer_resume(temp_timer);
+    }
 }
 
 void screen_main_hide(void)
@@ -173,6 +217,9 @@ void screen_main_hide(void)
     if (update_timer) {
         lv_timer_pause(update_timer);
     }
+    if (temp_timer) {
+        lv_timer_pause(temp_timer);
+    }
 }
 
 void screen_main_update_temperature(float temp_celsius)
@@ -192,6 +239,19 @@ void screen_main_update_temperature(float temp_celsius)
     ui_common_set_label_color(lbl_temperature, temp_str, color);
 }
 
+void screen_main_show_sensor_fault(uint32_t flags)
+{
+    if (!lbl_temperature) return;
+
+    const char *text = "ERR";
+    if (flags & SENSOR_FLAG_OPEN) {
+        text = "OPEN";
+    } else if (flags & SENSOR_FLAG_SHORT) {
+        text = "SHRT";
+    }
+    ui_common_set_label_color(lbl_temperature, text, COLOR_TEMP_CRITICAL);
+}
+
 void screen_main_update_time(void)
 {
     if (!lbl_time) return;
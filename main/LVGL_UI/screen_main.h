@@ -34,6 +34,12 @@ void screen_main_hide(void);
  */
 void screen_main_update_temperature(float temp_celsius);
 
+/**
+ * Replace the temperature with a fault indication (OPEN / SHRT / ERR)
+ * @param flags Control channel flags from the sensor sample
+ */
+void screen_main_show_sensor_fault(uint32_t flags);
+
 /**
  * Update time display
  */
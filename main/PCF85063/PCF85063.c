@@ -10,11 +10,21 @@
 *
 ******************************************************************************/
 #include "PCF85063.h"
+#include <sys/time.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *RTC_TAG = "RTC";
 
 datetime_t datetime= {0};
+static int64_t last_resync_us = 0;		// esp_timer time of the last RTC comparison
 
 static uint8_t decToBcd(int val);
 static int bcdToDec(uint8_t val);
+static int64_t datetime_to_epoch(const datetime_t *time);
+static void epoch_to_datetime(time_t epoch, datetime_t *time);
 
 const unsigned char MonthStr[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov","Dec"};
 /******************************************************************************
@@ -28,6 +38,8 @@ void PCF85063_Init()
 	uint8_t Value = RTC_CTRL_1_DEFAULT|RTC_CTRL_1_CAP_SEL;
 
 	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_CTRL_1_ADDR, &Value, 1));
+	I2C_Set_Coalesce(PCF85063_ADDRESS, true);	// Register address auto-increments
+	RTC_Sync_System_Clock();
 
 	// datetime_t Now_datetime= {0};
 	// Now_datetime.year = 2024;
@@ -40,9 +52,81 @@ void PCF85063_Init()
 	// PCF85063_Set_All(Now_datetime);
 }
 
+/******************************************************************************
+function:	Refresh datetime from the system clock
+parameter:
+Info:		No I2C except for the drift check every RTC_RESYNC_S. The RTC only
+			shows whole seconds, so a clock aligned to it can legitimately
+			read one second apart near a second boundary; in the middle of
+			a system second any mismatch is real drift.
+******************************************************************************/
 void RTC_Loop(void)
 {
-  PCF85063_Read_Time(&datetime);
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	int64_t now_us = esp_timer_get_time();
+	if (now_us - last_resync_us >= (int64_t)RTC_RESYNC_S * 1000000) {
+		datetime_t rtc;
+		PCF85063_Read_Time(&rtc);
+		last_resync_us = now_us;
+		bool mid_second = tv.tv_usec >= 250000 && tv.tv_usec < 750000;
+		int64_t tol_s = mid_second ? RTC_STEP_MIN_S : RTC_STEP_MIN_S + 1;
+		int64_t drift_s = datetime_to_epoch(&rtc) - (int64_t)tv.tv_sec;
+		if (drift_s >= tol_s || drift_s <= -tol_s) {
+			tv.tv_sec += drift_s;
+			settimeofday(&tv, NULL);
+			ESP_LOGW(RTC_TAG, "System clock %+lld s off the RTC, stepped", (long long)drift_s);
+		}
+	}
+
+	epoch_to_datetime(tv.tv_sec, &datetime);
+}
+
+/******************************************************************************
+function:	Set the system clock from the RTC
+parameter:
+Info:		The PCF85063 only resolves whole seconds, so wait for its seconds
+			register to tick and set the system clock at that edge (to within
+			one 10 ms poll) rather than up to a second late.
+******************************************************************************/
+esp_err_t RTC_Sync_System_Clock(void)
+{
+	uint8_t first = 0, sec = 0;
+	esp_err_t ret = I2C_Read(PCF85063_ADDRESS, RTC_SECOND_ADDR, &first, 1);
+	for (int i = 0; ret == ESP_OK && i < 110; i++) {
+		vTaskDelay(pdMS_TO_TICKS(10));
+		ret = I2C_Read(PCF85063_ADDRESS, RTC_SECOND_ADDR, &sec, 1);
+		if (sec != first) {
+			break;
+		}
+	}
+	if (ret != ESP_OK) {
+		ESP_LOGE(RTC_TAG, "RTC read failed, system clock not set: %s", esp_err_to_name(ret));
+		return ret;
+	}
+
+	datetime_t rtc;
+	PCF85063_Read_Time(&rtc);
+	struct timeval tv = { .tv_sec = (time_t)datetime_to_epoch(&rtc), .tv_usec = 0 };
+	settimeofday(&tv, NULL);
+	last_resync_us = esp_timer_get_time();
+	epoch_to_datetime(tv.tv_sec, &datetime);
+	ESP_LOGI(RTC_TAG, "System clock set from RTC: %d-%02d-%02d %02d:%02d:%02d", rtc.year, rtc.month, rtc.day,
+			 rtc.hour, rtc.minute, rtc.second);
+	return ESP_OK;
+}
+
+/******************************************************************************
+function:	Wall clock in microseconds
+parameter:
+Info:		From the system clock, no I2C
+******************************************************************************/
+int64_t RTC_Get_Epoch_Us(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
 }
 /******************************************************************************
 function:	Reset PCF85063
@@ -66,6 +150,7 @@ void PCF85063_Set_Time(datetime_t time)
 					  decToBcd(time.minute),
 					  decToBcd(time.hour)};
 	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_SECOND_ADDR, buf, 3));
+	RTC_Sync_System_Clock();
 }
 
 /******************************************************************************
@@ -80,6 +165,7 @@ void PCF85063_Set_Date(datetime_t date)
 					  decToBcd(date.month),
 					  decToBcd(date.year - YEAR_OFFSET)};
 	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_DAY_ADDR, buf, 4));
+	RTC_Sync_System_Clock();
 }
 
 /******************************************************************************
@@ -89,14 +175,21 @@ Info:
 ******************************************************************************/
 void PCF85063_Set_All(datetime_t time)
 {
-	uint8_t buf[7] = {decToBcd(time.second),
+	uint8_t hms[3] = {decToBcd(time.second),
 					  decToBcd(time.minute),
-					  decToBcd(time.hour),
-					  decToBcd(time.day),
-					  decToBcd(time.dotw),
-					  decToBcd(time.month),
-					  decToBcd(time.year - YEAR_OFFSET)};
-	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_SECOND_ADDR, buf, 7));
+					  decToBcd(time.hour)};
+	uint8_t date[4] = {decToBcd(time.day),
+					   decToBcd(time.dotw),
+					   decToBcd(time.month),
+					   decToBcd(time.year - YEAR_OFFSET)};
+	/* Seconds..years are consecutive registers: one transfer, no staging buffer */
+	const i2c_seg_t segs[2] = {{hms, sizeof(hms)}, {date, sizeof(date)}};
+	ESP_ERROR_CHECK(I2C_Write_Segs(PCF85063_ADDRESS, RTC_SECOND_ADDR, segs, 2, I2C_PRIO_NORMAL));
+
+	/* The RTC restarts its second when the seconds register is written */
+	struct timeval tv = { .tv_sec = (time_t)datetime_to_epoch(&time), .tv_usec = 0 };
+	settimeofday(&tv, NULL);
+	last_resync_us = esp_timer_get_time();
 }
 
 /******************************************************************************
@@ -107,7 +200,7 @@ Info:
 void PCF85063_Read_Time(datetime_t *time)
 {
 	uint8_t buf[7] = {0};
-	ESP_ERROR_CHECK(I2C_Read(PCF85063_ADDRESS, RTC_SECOND_ADDR, buf, 7));
+	ESP_ERROR_CHECK(I2C_Read_Prio(PCF85063_ADDRESS, RTC_SECOND_ADDR, buf, 7, I2C_PRIO_LOW));
 	time->second = bcdToDec(buf[0] & 0x7F);
 	time->minute = bcdToDec(buf[1] & 0x7F);
 	time->hour = bcdToDec(buf[2] & 0x3F);
@@ -160,7 +253,7 @@ void PCF85063_Set_Alarm(datetime_t time)
 		RTC_ALARM, 	//disalbe day
 		RTC_ALARM	//disalbe weekday
 	};
-	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_SECOND_ALARM, buf, 6));
+	ESP_ERROR_CHECK(I2C_Write(PCF85063_ADDRESS, RTC_SECOND_ALARM, buf, sizeof(buf)));
 }
 
 /******************************************************************************
@@ -200,6 +293,41 @@ static int bcdToDec(uint8_t val)
 	return (int)((val / 16 * 10) + (val % 16));
 }
 
+/******************************************************************************
+function:	datetime (UTC) to seconds since 1970
+parameter:
+Info:		Days-from-civil, independent of TZ and of mktime()
+******************************************************************************/
+static int64_t datetime_to_epoch(const datetime_t *time)
+{
+	int y = time->year - (time->month <= 2);
+	int era = (y >= 0 ? y : y - 399) / 400;
+	int yoe = y - era * 400;
+	int mp = (time->month + 9) % 12;
+	int doy = (153 * mp + 2) / 5 + time->day - 1;
+	int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	int64_t days = (int64_t)era * 146097 + doe - 719468;
+	return days * 86400 + time->hour * 3600 + time->minute * 60 + time->second;
+}
+
+/******************************************************************************
+function:	seconds since 1970 to datetime (UTC)
+parameter:
+Info:
+******************************************************************************/
+static void epoch_to_datetime(time_t epoch, datetime_t *time)
+{
+	struct tm tm;
+	gmtime_r(&epoch, &tm);
+	time->year = tm.tm_year + 1900;
+	time->month = tm.tm_mon + 1;
+	time->day = tm.tm_mday;
+	time->dotw = tm.tm_wday;
+	time->hour = tm.tm_hour;
+	time->minute = tm.tm_min;
+	time->second = tm.tm_sec;
+}
+
 /******************************************************************************
 function:	
 parameter:	
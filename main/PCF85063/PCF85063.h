@@ -60,6 +60,10 @@
 
 #define RTC_TIMER_FLAG		(0x08)
 
+// system clock sync
+#define RTC_RESYNC_S		(3600)	// seconds between drift checks against the PCF85063
+#define RTC_STEP_MIN_S		(1)		// step the system clock once it is this many whole seconds off
+
 typedef struct {
     uint16_t year;
     uint8_t month;
@@ -74,7 +78,9 @@ typedef struct {
 extern datetime_t datetime;
 
 void PCF85063_Init(void);
-void RTC_Loop(void);
+void RTC_Loop(void);							// refresh datetime from the system clock, resync with the RTC when due
+esp_err_t RTC_Sync_System_Clock(void);			// set the system clock from the RTC, aligned to its seconds edge (blocks <= 1 s)
+int64_t RTC_Get_Epoch_Us(void);				// wall clock in microseconds since 1970 (UTC)
 void PCF85063_Reset(void);
 
 void PCF85063_Set_Time(datetime_t time);
@@ -0,0 +1,92 @@
+#include "IMU_Vibe.h"
+
+#include <math.h>
+#include <string.h>
+
+/***********************
+ *  STATIC VARIABLES
+ ***********************/
+static const uint16_t bin_hz[IMU_VIBE_BINS] = IMU_VIBE_BIN_HZ;
+
+/***********************
+ *  STATIC FUNCTIONS
+ ***********************/
+static void reset_block(imu_vibe_state_t *v)
+{
+    v->n = 0;
+    memset(v->acc_sum, 0, sizeof(v->acc_sum));
+    memset(v->acc_sumsq, 0, sizeof(v->acc_sumsq));
+    memset(v->gyro_sum, 0, sizeof(v->gyro_sum));
+    memset(v->gyro_sumsq, 0, sizeof(v->gyro_sumsq));
+    v->peak_sq = 0;
+    memset(v->s1, 0, sizeof(v->s1));
+    memset(v->s2, 0, sizeof(v->s2));
+}
+
+/* RMS about the mean from raw sums: sqrt(E[x^2] - E[x]^2) */
+static float ac_rms(int64_t sum, int64_t sumsq, uint16_t n, float scale)
+{
+    double mean = (double)sum / n;
+    double var = (double)sumsq / n - mean * mean;
+    return var > 0.0 ? (float)sqrt(var) * scale : 0.0f;
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void IMU_Vibe_Init(imu_vibe_state_t *v, uint32_t odr_hz, uint16_t block, float acc_g_per_lsb, float gyro_dps_per_lsb)
+{
+    v->block = block > 0 ? block : 1;
+    v->acc_g_per_lsb = acc_g_per_lsb;
+    v->gyro_dps_per_lsb = gyro_dps_per_lsb;
+    for (int b = 0; b < IMU_VIBE_BINS; b++) {
+        v->coeff[b] = 2.0f * cosf(2.0f * (float)M_PI * bin_hz[b] / (float)odr_hz);
+    }
+    reset_block(v);
+}
+
+bool IMU_Vibe_Push(imu_vibe_state_t *v, const int16_t raw[6], imu_vibe_t *out)
+{
+    int64_t mag_sq = 0;
+    for (int i = 0; i < 3; i++) {
+        int32_t a = raw[i];
+        int32_t g = raw[3 + i];
+        v->acc_sum[i] += a;
+        v->acc_sumsq[i] += (int64_t)a * a;
+        v->gyro_sum[i] += g;
+        v->gyro_sumsq[i] += (int64_t)g * g;
+        mag_sq += (int64_t)a * a;
+    }
+    if (mag_sq > v->peak_sq) {
+        v->peak_sq = mag_sq;
+    }
+
+    /* Goertzel on |a| in g */
+    float x = sqrtf((float)mag_sq) * v->acc_g_per_lsb;
+    for (int b = 0; b < IMU_VIBE_BINS; b++) {
+        float s0 = x + v->coeff[b] * v->s1[b] - v->s2[b];
+        v->s2[b] = v->s1[b];
+        v->s1[b] = s0;
+    }
+
+    if (++v->n < v->block) {
+        return false;
+    }
+
+    uint16_t n = v->n;
+    out->frames = n;
+    for (int i = 0; i < 3; i++) {
+        out->acc_rms_g[i] = ac_rms(v->acc_sum[i], v->acc_sumsq[i], n, v->acc_g_per_lsb);
+        out->acc_mean_g[i] = (float)((double)v->acc_sum[i] / n) * v->acc_g_per_lsb;
+        out->gyro_rms_dps[i] = ac_rms(v->gyro_sum[i], v->gyro_sumsq[i], n, v->gyro_dps_per_lsb);
+    }
+    out->acc_peak_g = sqrtf((float)v->peak_sq) * v->acc_g_per_lsb;
+    for (int b = 0; b < IMU_VIBE_BINS; b++) {
+        /* |X_k|^2 = s1^2 + s2^2 - coeff s1 s2; a sine of amplitude A gives |X_k| = A n / 2 */
+        float p = v->s1[b] * v->s1[b] + v->s2[b] * v->s2[b] - v->coeff[b] * v->s1[b] * v->s2[b];
+        out->band_g[b] = p > 0.0f ? 2.0f * sqrtf(p) / n : 0.0f;
+    }
+
+    reset_block(v);
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/***********************
+ *  VIBRATION SUMMARY
+ *  Streams raw 6-axis frames (acc x/y/z, gyro x/y/z) and closes a summary
+ *  every `block` frames: per-axis AC RMS, peak |a| and the amplitude of
+ *  |a| at a few fixed frequencies. The spectrum uses one Goertzel filter
+ *  per bin instead of an FFT: O(bins) per frame, no sample buffer, and
+ *  with integer-Hz bins over a one-second block every bin is exact, so
+ *  the 1 g of gravity in |a| does not leak into it. Plain C with no
+ *  ESP-IDF dependencies.
+ ***********************/
+#define IMU_VIBE_BINS       8
+#define IMU_VIBE_BIN_HZ     { 10, 20, 30, 50, 80, 120, 160, 200 }   // Each < ODR / 2
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct {
+    int64_t  timestamp_us;              // End of the block (set by the caller)
+    uint16_t frames;
+    float    acc_rms_g[3];              // Per-axis RMS about the block mean (vibration)
+    float    acc_mean_g[3];             // Per-axis mean (gravity + sustained g-load)
+    float    acc_peak_g;                // Largest |a| in the block
+    float    gyro_rms_dps[3];
+    float    band_g[IMU_VIBE_BINS];     // Amplitude of |a| at IMU_VIBE_BIN_HZ
+} imu_vibe_t;
+
+typedef struct {
+    /* Configuration */
+    uint16_t block;
+    float    acc_g_per_lsb;
+    float    gyro_dps_per_lsb;
+    float    coeff[IMU_VIBE_BINS];      // 2 cos(2 pi f / ODR)
+    /* Block accumulators */
+    uint16_t n;
+    int64_t  acc_sum[3];
+    int64_t  acc_sumsq[3];
+    int64_t  gyro_sum[3];
+    int64_t  gyro_sumsq[3];
+    int64_t  peak_sq;                   // Largest ax^2 + ay^2 + az^2, raw
+    float    s1[IMU_VIBE_BINS];         // Goertzel state
+    float    s2[IMU_VIBE_BINS];
+} imu_vibe_state_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * @param odr_hz  Frame rate
+ * @param block   Frames per summary (odr_hz for one-second blocks with exact bins)
+ */
+void IMU_Vibe_Init(imu_vibe_state_t *v, uint32_t odr_hz, uint16_t block, float acc_g_per_lsb, float gyro_dps_per_lsb);
+
+/**
+ * Add one frame: raw[0..2] accelerometer, raw[3..5] gyro, in sensor LSBs.
+ * @return true when this frame closed a block and `out` was filled
+ */
+bool IMU_Vibe_Push(imu_vibe_state_t *v, const int16_t raw[6], imu_vibe_t *out);
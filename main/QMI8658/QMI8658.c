@@ -1,5 +1,9 @@
 #include "QMI8658.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
 IMUdata Accel;
 IMUdata Gyro;
 
@@ -26,6 +30,7 @@ void QMI8658_Init(void)
     I2C_Read(Device_addr, QMI8658_REVISION_ID, buf, 1);
     printf("QMI8658 Device ID: %x\r\n",buf[0]);    // Get chip id
     setState(sensor_running);             
+    I2C_Set_Coalesce(Device_addr, true);     // CTRL1 ADDR_AI set by setState(): register address auto-increments
 
     setAccScale(acc_scale);            
     setAccODR(acc_odr);                    
@@ -264,7 +269,7 @@ void getAccelerometer(void)
 {
 
     uint8_t buf[6];
-    I2C_Read(Device_addr, QMI8658_AX_L, buf, 6);
+    I2C_Read_Prio(Device_addr, QMI8658_AX_L, buf, 6, I2C_PRIO_LOW);
     Accel.x = (float)((int16_t)((buf[1]<<8) | (buf[0])));
     Accel.y = (float)((int16_t)((buf[3]<<8) | (buf[2])));
     Accel.z = (float)((int16_t)((buf[5]<<8) | (buf[4])));
@@ -276,7 +281,7 @@ void getAccelerometer(void)
 void getGyroscope(void)
 {
     uint8_t buf[6];
-    I2C_Read(Device_addr, QMI8658_GX_L, buf, 6);
+    I2C_Read_Prio(Device_addr, QMI8658_GX_L, buf, 6, I2C_PRIO_LOW);
     Gyro.x = (float)((int16_t)((buf[1]<<8) | (buf[0])));
     Gyro.y = (float)((int16_t)((buf[3]<<8) | (buf[2])));
     Gyro.z = (float)((int16_t)((buf[5]<<8) | (buf[4])));
@@ -285,19 +290,188 @@ void getGyroscope(void)
     Gyro.z = Gyro.z * gyroScales;
 }
 
+#if IMU_FIFO_ENABLE
+/***********************
+ *  FIFO ACQUISITION
+ *  One drain per watermark: read the level, open the FIFO with
+ *  CTRL_CMD_REQ_FIFO, read FIFO_DATA in IMU_FIFO_CHUNK_FRAMES pieces at
+ *  LOW priority, then close it again. The level is re-read each time, so a
+ *  late drain simply takes more frames; stream mode only loses the oldest
+ *  ones if a drain is more than a full FIFO late.
+ ***********************/
+static const char *IMU_TAG = "QMI8658";
+
+static TaskHandle_t s_imu_task = NULL;
+static uint8_t s_fifo_buf[IMU_FIFO_FRAMES * IMU_FIFO_FRAME_BYTES];
+static imu_vibe_state_t s_vibe;
+
+static imu_vibe_t s_vibe_ring[IMU_VIBE_RING];
+static uint32_t s_vibe_head = 0;                // Summaries published so far
+static portMUX_TYPE s_vibe_mux = portMUX_INITIALIZER_UNLOCKED;
 
+/**
+ * CTRL9 command handshake with a bounded wait: write the command, poll
+ * CmdDone (STATUSINT bit 7), then acknowledge so the next command starts
+ * from a clean state.
+ */
+static esp_err_t ctrl9_cmd(uint8_t command)
+{
+    esp_err_t ret = I2C_Write_Prio(Device_addr, QMI8658_CTRL9, &command, 1, I2C_PRIO_LOW);
+    for (int i = 0; ret == ESP_OK && i < 20; i++) {
+        uint8_t status;
+        ret = I2C_Read_Prio(Device_addr, QMI8658_STATUSINT, &status, 1, I2C_PRIO_LOW);
+        if (ret == ESP_OK && (status & 0x80)) {
+            uint8_t ack = QMI8658_CTRL_CMD_ACK;
+            return I2C_Write_Prio(Device_addr, QMI8658_CTRL9, &ack, 1, I2C_PRIO_LOW);
+        }
+    }
+    return ret == ESP_OK ? ESP_ERR_TIMEOUT : ret;
+}
 
+static void publish_vibe(const imu_vibe_t *v)
+{
+    taskENTER_CRITICAL(&s_vibe_mux);
+    s_vibe_ring[s_vibe_head % IMU_VIBE_RING] = *v;
+    s_vibe_head++;
+    taskEXIT_CRITICAL(&s_vibe_mux);
+}
 
+static void fifo_drain(void)
+{
+    /* FIFO_SMPL_CNT and FIFO_STATUS in one read */
+    uint8_t lvl[2];
+    if (I2C_Read_Prio(Device_addr, QMI8658_FIFO_SMPL_CNT, lvl, 2, I2C_PRIO_LOW) != ESP_OK) {
+        return;
+    }
+    if (lvl[1] & QMI8658_FIFO_STATUS_OVFL) {
+        ESP_LOGW(IMU_TAG, "FIFO overflow, oldest frames lost");
+    }
+    uint32_t bytes = ((((uint32_t)(lvl[1] & QMI8658_FIFO_STATUS_CNT_MSB)) << 8) | lvl[0]) * 2;
+    uint32_t frames = bytes / IMU_FIFO_FRAME_BYTES;
+    if (frames > IMU_FIFO_FRAMES) {
+        frames = IMU_FIFO_FRAMES;
+    }
+    if (frames == 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
 
+    if (ctrl9_cmd(QMI8658_CTRL_CMD_REQ_FIFO) != ESP_OK) {
+        ESP_LOGW(IMU_TAG, "FIFO read request not acknowledged");
+        return;
+    }
+    /* Each chunk is a separate LOW transaction, so HIGH (touch) requests
+     * are served between them. FIFO_DATA does not auto-increment; the bus
+     * manager only merges reads at consecutive registers, never these. */
+    esp_err_t ret = ESP_OK;
+    for (uint32_t done = 0; done < frames && ret == ESP_OK; ) {
+        uint32_t n = frames - done;
+        if (n > IMU_FIFO_CHUNK_FRAMES) {
+            n = IMU_FIFO_CHUNK_FRAMES;
+        }
+        ret = I2C_Read_Prio(Device_addr, QMI8658_FIFO_DATA, &s_fifo_buf[done * IMU_FIFO_FRAME_BYTES],
+                            n * IMU_FIFO_FRAME_BYTES, I2C_PRIO_LOW);
+        done += n;
+    }
+    /* Leave FIFO read mode so the sensor resumes filling it */
+    uint8_t fifo_ctrl = QMI8658_FIFO_MODE_STREAM | QMI8658_FIFO_SIZE_128;
+    I2C_Write_Prio(Device_addr, QMI8658_FIFO_CTRL, &fifo_ctrl, 1, I2C_PRIO_LOW);
+    if (ret != ESP_OK) {
+        return;
+    }
 
+    int16_t raw[6];
+    for (uint32_t f = 0; f < frames; f++) {
+        const uint8_t *p = &s_fifo_buf[f * IMU_FIFO_FRAME_BYTES];
+        for (int i = 0; i < 6; i++) {
+            raw[i] = (int16_t)((p[2 * i + 1] << 8) | p[2 * i]);
+        }
+        imu_vibe_t v;
+        if (IMU_Vibe_Push(&s_vibe, raw, &v)) {
+            /* The newest frame in the FIFO was sampled about now */
+            v.timestamp_us = now - (int64_t)(frames - 1 - f) * 1000000 / IMU_ODR_HZ;
+            publish_vibe(&v);
+        }
+    }
+    Accel.x = raw[0] * accelScales;
+    Accel.y = raw[1] * accelScales;
+    Accel.z = raw[2] * accelScales;
+    Gyro.x = raw[3] * gyroScales;
+    Gyro.y = raw[4] * gyroScales;
+    Gyro.z = raw[5] * gyroScales;
+}
 
+#if IMU_INT_GPIO >= 0
+static void IRAM_ATTR imu_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_imu_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+#else
+static void drain_timer_cb(void *arg)
+{
+    xTaskNotifyGive(s_imu_task);
+}
+#endif
 
+static void imu_task_fn(void *arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        fifo_drain();
+    }
+}
 
+void QMI8658_FIFO_Start(void)
+{
+    setAccODR(IMU_ACC_ODR);
+    setGyroODR(IMU_GYRO_ODR);
+    IMU_Vibe_Init(&s_vibe, IMU_ODR_HZ, IMU_ODR_HZ, accelScales, gyroScales);
+
+    QMI8658_transmit(QMI8658_FIFO_WTM_TH, IMU_FIFO_WATERMARK);
+    QMI8658_transmit(QMI8658_FIFO_CTRL, QMI8658_FIFO_MODE_STREAM | QMI8658_FIFO_SIZE_128);
+    if (ctrl9_cmd(QMI8658_CTRL_CMD_RST_FIFO) != ESP_OK) {
+        ESP_LOGE(IMU_TAG, "FIFO reset not acknowledged, vibration logging disabled");
+        return;
+    }
 
+    xTaskCreatePinnedToCore(imu_task_fn, "imu_fifo", IMU_TASK_STACK, NULL, IMU_TASK_PRIORITY, &s_imu_task, 0);
+#if IMU_INT_GPIO >= 0
+    /* Route the FIFO watermark to the INT pins (CTRL1 INT1_EN | INT2_EN) */
+    QMI8658_transmit(QMI8658_CTRL1, QMI8658_receive(QMI8658_CTRL1) | 0x18);
+    const gpio_config_t int_cfg = {
+        .pin_bit_mask = 1ULL << IMU_INT_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    gpio_config(&int_cfg);
+    gpio_install_isr_service(0);            // ESP_ERR_INVALID_STATE if another driver already did
+    gpio_isr_handler_add(IMU_INT_GPIO, imu_isr, NULL);
+#else
+    const esp_timer_create_args_t drain_args = {
+        .callback = drain_timer_cb,
+        .name = "imu_drain",
+    };
+    esp_timer_handle_t drain_timer;
+    ESP_ERROR_CHECK(esp_timer_create(&drain_args, &drain_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(drain_timer, (uint64_t)IMU_FIFO_WATERMARK * 1000000 / IMU_ODR_HZ));
+#endif
+    ESP_LOGI(IMU_TAG, "FIFO mode: %d Hz, drain every %d frames", IMU_ODR_HZ, IMU_FIFO_WATERMARK);
+}
 
-
-
-
-
-
-
+size_t QMI8658_Vibe_Read(uint32_t *Cursor, imu_vibe_t *Out, size_t Max)
+{
+    size_t n = 0;
+    taskENTER_CRITICAL(&s_vibe_mux);
+    if (s_vibe_head - *Cursor > IMU_VIBE_RING) {
+        *Cursor = s_vibe_head - IMU_VIBE_RING;
+    }
+    while (n < Max && *Cursor != s_vibe_head) {
+        Out[n++] = s_vibe_ring[*Cursor % IMU_VIBE_RING];
+        (*Cursor)++;
+    }
+    taskEXIT_CRITICAL(&s_vibe_mux);
+    return n;
+}
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "I2C_Driver.h"
+#include "IMU_Vibe.h"
 
 //device address
 #define QMI8658_L_SLAVE_ADDRESS                 (0x6B)
@@ -27,6 +28,20 @@
 #define QMI8658_CAL4_L  0x11  // calibration 4 register, lower bits
 #define QMI8658_CAL4_H  0x12  // calibration 4 register, higher bits
 
+#define QMI8658_FIFO_WTM_TH   0x13 // FIFO watermark, in frames (one ODR sample of every enabled sensor)
+#define QMI8658_FIFO_CTRL     0x14 // FIFO mode, size and read mode
+#define QMI8658_FIFO_SMPL_CNT 0x15 // FIFO level, lower 8 bits (level * 2 = bytes)
+#define QMI8658_FIFO_STATUS   0x16 // FIFO flags + level bits 9:8
+#define QMI8658_FIFO_DATA     0x17 // FIFO read port (does not auto-increment)
+
+#define QMI8658_FIFO_MODE_STREAM 0x02 // FIFO_CTRL: keep the newest frames when full
+#define QMI8658_FIFO_SIZE_128    0x0C // FIFO_CTRL: 128 frames
+#define QMI8658_FIFO_RD_MODE     0x80 // FIFO_CTRL: set by CTRL_CMD_REQ_FIFO, host clears it after the read
+#define QMI8658_FIFO_STATUS_FULL 0x80
+#define QMI8658_FIFO_STATUS_WTM  0x40
+#define QMI8658_FIFO_STATUS_OVFL 0x20
+#define QMI8658_FIFO_STATUS_CNT_MSB 0x03
+
 #define QMI8658_TEMP_L 0x33 // lower bits of temperature data
 #define QMI8658_TEMP_H 0x34 // upper bits of temperature data
 
@@ -66,6 +81,36 @@
 
 // control clock gating (necessary to use data locking)
 #define QMI8658_CTRL_CMD_AHB_CLOCK_GATING 0x12
+#define QMI8658_CTRL_CMD_ACK      0x00 // clears CmdDone after a CTRL9 command
+#define QMI8658_CTRL_CMD_RST_FIFO 0x04
+#define QMI8658_CTRL_CMD_REQ_FIFO 0x05 // open the FIFO for burst reads through FIFO_DATA
+
+/* FIFO acquisition: the sensor buffers frames at the ODR and a task drains
+ * them in burst reads once per watermark, so nothing polls per sample.
+ * Every block of IMU_ODR_HZ frames (one second) is reduced to a vibration
+ * summary (IMU_Vibe.h) for the telemetry log; Accel / Gyro follow the
+ * newest frame of each drain.
+ *
+ * Bus budget at 500 Hz, 6 axes: 500 x 12 bytes x 9 bits = 54 kbit/s of
+ * data alone. Each drain adds the level read, the CTRL9 handshake (three
+ * transactions when CmdDone is set on the first poll), eight chunk
+ * headers and the FIFO_CTRL write: ~7.3 kbit per 64 frames, ~57 kbit/s,
+ * 14-15 % of the 400 kHz bus shared with touch, RTC and EXIO. In the
+ * SD log's I2C statistics ("I" lines) 0x6B should gain about 100 txns,
+ * 6.0 KB rx and 145 ms busy per second. Lower IMU_ODR_HZ to cut it (the
+ * spectrum bins must stay below ODR / 2, IMU_VIBE_BIN_HZ). */
+#define IMU_FIFO_ENABLE         1
+#define IMU_INT_GPIO            -1        /*!< GPIO wired to the QMI8658 FIFO interrupt, -1 = drain on a timer at the watermark period */
+#define IMU_ODR_HZ              500       /*!< Must match IMU_ACC_ODR / IMU_GYRO_ODR */
+#define IMU_ACC_ODR             acc_odr_norm_500
+#define IMU_GYRO_ODR            gyro_odr_norm_500
+#define IMU_FIFO_FRAMES         128       /*!< Must match QMI8658_FIFO_SIZE_128 */
+#define IMU_FIFO_WATERMARK      64        /*!< Frames per drain: half the FIFO, 128 ms at 500 Hz */
+#define IMU_FIFO_FRAME_BYTES    12        /*!< acc x/y/z then gyro x/y/z, int16 little-endian */
+#define IMU_FIFO_CHUNK_FRAMES   8         /*!< Frames per bus read (~2.5 ms at 400 kHz), so a touch read never waits longer */
+#define IMU_TASK_PRIORITY       2
+#define IMU_TASK_STACK          3072
+#define IMU_VIBE_RING           8         /*!< Summaries kept for readers (seconds) */
 
 
 typedef enum {
@@ -158,4 +203,12 @@ float getGyroX();
 float getGyroY();
 float getGyroZ();
 void getAccelerometer(void);
-void getGyroscope(void);
\ No newline at end of file
+void getGyroscope(void);
+
+#if IMU_FIFO_ENABLE
+// Switch to FIFO acquisition and start the drain task. Call after QMI8658_Init()
+void QMI8658_FIFO_Start(void);
+// Copy up to Max vibration summaries published after *Cursor (start from 0), oldest first, and advance it.
+// Summaries more than IMU_VIBE_RING behind are skipped. Returns the number copied
+size_t QMI8658_Vibe_Read(uint32_t *Cursor, imu_vibe_t *Out, size_t Max);
+#endif
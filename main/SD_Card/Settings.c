@@ -9,6 +9,8 @@
 #include <errno.h>
 
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 /* Access the global runtime settings */
 #include "screen_trigger_temp.h"    /* g_trigger_temperature    */
@@ -20,6 +22,13 @@ static const char *TAG = "Settings";
 
 #define SETTINGS_DIR   "/sdcard/system"
 #define SETTINGS_PATH  "/sdcard/system/SETTINGS.TXT"
+#define SETTINGS_TMP   "/sdcard/system/SETTINGS.TMP"
+
+/* Brown-out protection: saves are refused while writes are locked out,
+ * and settings_set_writable(false) waits for a save in progress */
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_locked_out = false;
+static bool s_saving = false;
 
 /* --------------- helpers --------------------- */
 
@@ -37,6 +46,13 @@ static void ensure_dir(const char *path)
 esp_err_t settings_load(void)
 {
     FILE *f = fopen(SETTINGS_PATH, "r");
+    if (!f) {
+        /* Power lost between removing the old file and the rename in settings_save() */
+        if (rename(SETTINGS_TMP, SETTINGS_PATH) == 0) {
+            ESP_LOGW(TAG, "Recovered settings from %s", SETTINGS_TMP);
+            f = fopen(SETTINGS_PATH, "r");
+        }
+    }
     if (!f) {
         ESP_LOGW(TAG, "No settings file found, using defaults");
         return ESP_ERR_NOT_FOUND;
@@ -98,12 +114,26 @@ esp_err_t settings_load(void)
 
 esp_err_t settings_save(void)
 {
+    taskENTER_CRITICAL(&s_lock);
+    bool refused = s_locked_out || s_saving;
+    if (!refused) {
+        s_saving = true;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    if (refused) {
+        ESP_LOGW(TAG, "Settings not saved: storage writes locked (low supply)");
+        return ESP_ERR_INVALID_STATE;
+    }
+
     ensure_dir(SETTINGS_DIR);
 
-    FILE *f = fopen(SETTINGS_PATH, "w");
+    /* Write a temporary file and swap it in, so a power cut leaves either
+     * the old or the new settings on the card, never a truncated file */
+    esp_err_t ret = ESP_FAIL;
+    FILE *f = fopen(SETTINGS_TMP, "w");
     if (!f) {
-        ESP_LOGE(TAG, "Failed to open %s for writing (errno %d)", SETTINGS_PATH, errno);
-        return ESP_FAIL;
+        ESP_LOGE(TAG, "Failed to open %s for writing (errno %d)", SETTINGS_TMP, errno);
+        goto done;
     }
 
     fprintf(f, "# Intercooler Spray Controller Settings\n");
@@ -114,10 +144,37 @@ esp_err_t settings_save(void)
 
     fflush(f);
     fsync(fileno(f));
-    fclose(f);
+    if (fclose(f) != 0) {
+        ESP_LOGE(TAG, "Failed to write %s (errno %d)", SETTINGS_TMP, errno);
+        goto done;
+    }
+    /* FAT rename does not replace an existing file */
+    unlink(SETTINGS_PATH);
+    if (rename(SETTINGS_TMP, SETTINGS_PATH) != 0) {
+        ESP_LOGE(TAG, "Failed to rename %s (errno %d)", SETTINGS_TMP, errno);
+        goto done;
+    }
 
     ESP_LOGI(TAG, "Settings saved to %s", SETTINGS_PATH);
-    return ESP_OK;
+    ret = ESP_OK;
+done:
+    taskENTER_CRITICAL(&s_lock);
+    s_saving = false;
+    taskEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+void settings_set_writable(bool writable)
+{
+    taskENTER_CRITICAL(&s_lock);
+    s_locked_out = !writable;
+    taskEXIT_CRITICAL(&s_lock);
+
+    /* A save already past the check finishes first (a few ms); bounded so a
+     * stuck card cannot hold up the rest of the shutdown */
+    for (int i = 0; !writable && s_saving && i < 50; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
 }
 
 app_settings_t settings_get_current(void)
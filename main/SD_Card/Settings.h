@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 /**
@@ -28,12 +29,21 @@ esp_err_t settings_load(void);
 /**
  * @brief Save current settings to SD card.
  *
- * Writes /sdcard/system/SETTINGS.TXT with current runtime values.
+ * Writes /sdcard/system/SETTINGS.TXT with current runtime values, via a
+ * temporary file that replaces the old one only once it is complete.
  *
- * @return ESP_OK on success, ESP_FAIL on write error.
+ * @return ESP_OK on success, ESP_FAIL on write error,
+ *         ESP_ERR_INVALID_STATE while writes are locked out.
  */
 esp_err_t settings_save(void);
 
+/**
+ * @brief Allow or lock out settings writes (supply brown-out).
+ *
+ * Locking waits (up to 500 ms) for a save already in progress.
+ */
+void settings_set_writable(bool writable);
+
 /**
  * @brief Get a snapshot of the current settings.
  */
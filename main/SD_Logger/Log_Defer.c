@@ -0,0 +1,146 @@
+#include "Log_Defer.h"
+
+#include <string.h>
+
+/***********************
+ *  STATIC FUNCTIONS
+ ***********************/
+typedef struct {
+    uint8_t *buf;
+    size_t   max;
+    size_t   n;
+    bool     overflow;
+} writer_t;
+
+static void put(writer_t *w, const void *data, size_t len)
+{
+    if (w->n + len > w->max) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->n, data, len);
+    w->n += len;
+}
+
+static void put_tagged(writer_t *w, uint8_t tag, const void *data, size_t len)
+{
+    put(w, &tag, 1);
+    put(w, data, len);
+}
+
+static void put_i32(writer_t *w, int32_t v)
+{
+    put_tagged(w, LOG_DEFER_I32, &v, sizeof(v));
+}
+
+static void put_i64(writer_t *w, int64_t v)
+{
+    put_tagged(w, LOG_DEFER_I64, &v, sizeof(v));
+}
+
+static bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+size_t Log_Defer_Encode(uint8_t *out, size_t max, int64_t timestamp_us, log_defer_const_fn is_const,
+                        const char *fmt, va_list args)
+{
+    if (max < LOG_DEFER_ENTRY_HDR || !is_const(fmt)) {
+        return 0;
+    }
+    writer_t w = { .buf = out, .max = max, .n = LOG_DEFER_ENTRY_HDR };
+
+    for (const char *p = fmt; (p = strchr(p, '%')) != NULL; p++) {
+        p++;
+        if (*p == '%') {
+            continue;
+        }
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') p++;
+        if (*p == '*') {
+            put_i32(&w, va_arg(args, int));
+            p++;
+        } else {
+            while (is_digit(*p)) p++;
+        }
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                put_i32(&w, va_arg(args, int));
+                p++;
+            } else {
+                while (is_digit(*p)) p++;
+            }
+        }
+
+        /* Integer size after promotion: everything narrower than int arrives as int */
+        size_t size = sizeof(int);
+        switch (*p) {
+            case 'h': p += (p[1] == 'h') ? 2 : 1; break;
+            case 'l':
+                if (p[1] == 'l') { size = sizeof(long long); p += 2; }
+                else             { size = sizeof(long); p++; }
+                break;
+            case 'j': size = sizeof(intmax_t); p++; break;
+            case 'z': size = sizeof(size_t); p++; break;
+            case 't': size = sizeof(ptrdiff_t); p++; break;
+            case 'L': return 0;                 /* long double */
+            default: break;
+        }
+
+        switch (*p) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            if (size == sizeof(int64_t)) {
+                put_i64(&w, va_arg(args, long long));
+            } else {
+                put_i32(&w, va_arg(args, int));
+            }
+            break;
+        case 'p': {
+            uintptr_t v = (uintptr_t)va_arg(args, void *);
+            if (sizeof(v) == sizeof(int64_t)) {
+                put_i64(&w, (int64_t)v);
+            } else {
+                put_i32(&w, (int32_t)v);
+            }
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+            double v = va_arg(args, double);
+            put_tagged(&w, LOG_DEFER_F64, &v, sizeof(v));
+            break;
+        }
+        case 's': {
+            const char *s = va_arg(args, const char *);
+            if (s == NULL) {
+                s = "(null)";
+            }
+            if (is_const(s)) {
+                uint32_t addr = (uint32_t)(uintptr_t)s;
+                put_tagged(&w, LOG_DEFER_SREF, &addr, sizeof(addr));
+            } else {
+                size_t len = strnlen(s, LOG_DEFER_STR_MAX);
+                uint8_t len8 = (uint8_t)len;
+                put_tagged(&w, LOG_DEFER_STR, &len8, 1);
+                put(&w, s, len);
+            }
+            break;
+        }
+        default:
+            return 0;                           /* %n, or something the decoder cannot replay */
+        }
+        if (w.overflow) {
+            return 0;
+        }
+    }
+
+    uint16_t len = (uint16_t)w.n;
+    uint32_t addr = (uint32_t)(uintptr_t)fmt;
+    memcpy(out, &len, sizeof(len));
+    memcpy(out + 2, &addr, sizeof(addr));
+    memcpy(out + 6, &timestamp_us, sizeof(timestamp_us));
+    return w.n;
+}
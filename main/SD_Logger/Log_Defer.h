@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/***********************
+ *  DEFERRED LOG FORMAT
+ *  Instead of running printf, a log call is stored as the address of its
+ *  format string (a literal in flash, so it is in the app ELF), a
+ *  timestamp and its arguments in their raw binary form. The encoder only
+ *  walks the conversion specifiers to pull each argument off the va_list;
+ *  tools/log_decode re-runs the formatting on the host with the ELF.
+ *
+ *  File (D%05d.bin): log_defer_header_t, then entries of
+ *      uint16 len (whole entry), uint32 fmt address, int64 timestamp_us,
+ *      then per argument one tag byte and its value (little-endian):
+ *          LOG_DEFER_I32  4 bytes      int, long, size_t, char, %p (32-bit)
+ *          LOG_DEFER_I64  8 bytes      long long, intmax_t
+ *          LOG_DEFER_F64  8 bytes      double
+ *          LOG_DEFER_SREF 4 bytes      address of a string in flash
+ *          LOG_DEFER_STR  1 byte length + bytes, a copy of a RAM string
+ *  '*' widths / precisions are stored as LOG_DEFER_I32 in argument order.
+ *  Plain C with no ESP-IDF dependencies.
+ *
+ *  Bump LOG_DEFER_VERSION whenever the layout changes.
+ ***********************/
+#define LOG_DEFER_MAGIC         "ICDL"
+#define LOG_DEFER_VERSION       1
+#define LOG_DEFER_ENTRY_HDR     14          // len + fmt + timestamp
+#define LOG_DEFER_STR_MAX       255         // Longer RAM strings are truncated
+
+#define LOG_DEFER_I32           'i'
+#define LOG_DEFER_I64           'l'
+#define LOG_DEFER_F64           'd'
+#define LOG_DEFER_SREF          'r'
+#define LOG_DEFER_STR           's'
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct __attribute__((packed)) {
+    char     magic[4];          // LOG_DEFER_MAGIC
+    uint16_t version;           // LOG_DEFER_VERSION
+    uint16_t header_bytes;      // sizeof(log_defer_header_t)
+    char     elf_sha256[64];    // Hex SHA-256 of the app ELF the addresses belong to
+    int64_t  epoch_us;          // Wall clock (RTC) at timestamp_us, 0 if unknown
+    int64_t  timestamp_us;
+} log_defer_header_t;
+
+/** Returns true if p points into memory that is part of the app image (flash rodata) */
+typedef bool (*log_defer_const_fn)(const void *p);
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * Encode one log call.
+ * @param is_const  Decides which strings are stored by address. The format
+ *                  string must pass it, or nothing is encoded
+ * @return Entry length in bytes, 0 if the format is not in flash, uses a
+ *         conversion the decoder cannot replay (%n, %L...) or the entry
+ *         does not fit in max. The caller then logs it as text
+ */
+size_t Log_Defer_Encode(uint8_t *out, size_t max, int64_t timestamp_us, log_defer_const_fn is_const,
+                        const char *fmt, va_list args);
@@ -0,0 +1,348 @@
+#define _GNU_SOURCE                     /* fopencookie */
+#include "Log_File.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/unistd.h>
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_vfs_fat.h"
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct {
+    FILE     *stream;
+    int       fd;
+    uint8_t  *block;        // LOG_FILE_BLOCK bytes, DMA-capable so SDMMC needs no bounce copy
+    uint32_t  fill;         // Bytes of block in use
+    uint32_t  block_off;    // File offset of block
+    uint32_t  capacity;     // Preallocated size
+    bool      dirty;        // block holds bytes not yet on the card
+    bool      terminated;   // Zero padding on the card follows the data (not yet at open: the
+                            // clusters still hold whatever was deleted from them)
+    bool      overflowed;   // Past capacity: the file grows cluster by cluster again
+    bool      keep;         // Close without trimming the preallocation (suspend)
+} log_file_t;
+
+/***********************
+ *  STATIC VARIABLES
+ ***********************/
+static const char *TAG = "Log_File";
+
+/* Open preallocated streams. Callers serialise open / sync / close (SD_Logger's mutex) */
+static log_file_t *s_files[LOG_FILE_MAX];
+
+/***********************
+ *  STATIC FUNCTIONS
+ ***********************/
+static log_file_t *find(FILE *f)
+{
+    for (int i = 0; i < LOG_FILE_MAX; i++) {
+        if (s_files[i] && s_files[i]->stream == f) {
+            return s_files[i];
+        }
+    }
+    return NULL;
+}
+
+/** Write the whole block at its aligned offset; the unused tail is zero */
+static int put_block(log_file_t *lf)
+{
+    if (lseek(lf->fd, (off_t)lf->block_off, SEEK_SET) < 0 ||
+        write(lf->fd, lf->block, LOG_FILE_BLOCK) != LOG_FILE_BLOCK) {
+        return -1;
+    }
+    if (!lf->overflowed && lf->block_off + lf->fill > lf->capacity) {
+        lf->overflowed = true;
+        ESP_LOGW(TAG, "Log file past its %lu KB preallocation, growing normally",
+                 (unsigned long)(lf->capacity / 1024));
+    }
+    lf->dirty = false;
+    lf->terminated = lf->fill < LOG_FILE_BLOCK;
+    return 0;
+}
+
+static ssize_t cookie_write(void *cookie, const char *buf, size_t n)
+{
+    log_file_t *lf = cookie;
+    size_t done = 0;
+    while (done < n) {
+        uint32_t chunk = LOG_FILE_BLOCK - lf->fill;
+        if (chunk > n - done) {
+            chunk = (uint32_t)(n - done);
+        }
+        memcpy(lf->block + lf->fill, buf + done, chunk);
+        lf->fill += chunk;
+        lf->dirty = true;
+        done += chunk;
+        if (lf->fill == LOG_FILE_BLOCK) {
+            if (put_block(lf) != 0) {
+                lf->fill -= chunk;
+                done -= chunk;
+                return done ? (ssize_t)done : -1;
+            }
+            lf->block_off += LOG_FILE_BLOCK;
+            lf->fill = 0;
+            memset(lf->block, 0, LOG_FILE_BLOCK);
+        }
+    }
+    return (ssize_t)n;
+}
+
+/** Current block out (zero-padded), then trim the preallocation to what was written */
+static int cookie_close(void *cookie)
+{
+    log_file_t *lf = cookie;
+    int ret = 0;
+    if (lf->dirty && put_block(lf) != 0) {
+        ret = -1;
+    }
+    if (lf->keep) {
+        if (fsync(lf->fd) != 0) {
+            ret = -1;
+        }
+    } else if (ftruncate(lf->fd, (off_t)(lf->block_off + lf->fill)) != 0) {
+        ret = -1;
+    }
+    if (close(lf->fd) != 0) {
+        ret = -1;
+    }
+    for (int i = 0; i < LOG_FILE_MAX; i++) {
+        if (s_files[i] == lf) {
+            s_files[i] = NULL;
+        }
+    }
+    heap_caps_free(lf->block);
+    free(lf);
+    return ret;
+}
+
+static FILE *open_stdio(const char *path, const char *mode)
+{
+    FILE *f = fopen(path, mode);
+    if (f) {
+        setvbuf(f, NULL, _IOFBF, LOG_FILE_BLOCK);
+    }
+    return f;
+}
+
+static void lf_free(log_file_t *lf)
+{
+    heap_caps_free(lf->block);
+    free(lf);
+}
+
+/** Free slot and zeroed block buffer for a preallocated stream, NULL if there is none */
+static log_file_t *lf_new(const char *path, int *slot)
+{
+    *slot = 0;
+    while (*slot < LOG_FILE_MAX && s_files[*slot]) {
+        (*slot)++;
+    }
+    log_file_t *lf = calloc(1, sizeof(*lf));
+    if (lf) {
+        lf->fd = -1;
+        lf->block = heap_caps_calloc(1, LOG_FILE_BLOCK, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+    if (*slot == LOG_FILE_MAX || !lf || !lf->block) {
+        ESP_LOGW(TAG, "No preallocation slot / block buffer for %s, appending", path);
+        if (lf) {
+            lf_free(lf);
+        }
+        return NULL;
+    }
+    return lf;
+}
+
+/** Wrap lf->fd in a stream and register it; frees lf (closing the fd) on failure */
+static FILE *lf_attach(log_file_t *lf, int slot)
+{
+    if (lf->fd >= 0) {
+        lf->stream = fopencookie(lf, "w", (cookie_io_functions_t){ .write = cookie_write, .close = cookie_close });
+        if (lf->stream) {
+            s_files[slot] = lf;
+            return lf->stream;
+        }
+        close(lf->fd);
+    }
+    lf_free(lf);
+    return NULL;
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+FILE *Log_File_Open(const char *path, const char *mode, uint32_t prealloc_bytes)
+{
+    if (prealloc_bytes == 0 || mode[0] != 'w') {
+        return open_stdio(path, mode);
+    }
+    prealloc_bytes = (prealloc_bytes + LOG_FILE_BLOCK - 1) & ~(uint32_t)(LOG_FILE_BLOCK - 1);
+
+    int slot;
+    log_file_t *lf = lf_new(path, &slot);
+    if (!lf) {
+        return open_stdio(path, mode);
+    }
+
+    /* Replaces any old file; clusters are reserved now, as one run */
+    unlink(path);
+    esp_err_t err = esp_vfs_fat_create_contiguous_file(LOG_FILE_MOUNT, path, prealloc_bytes, true);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No contiguous %lu KB for %s (%s), appending", (unsigned long)(prealloc_bytes / 1024),
+                 path, esp_err_to_name(err));
+        lf_free(lf);
+        return open_stdio(path, mode);
+    }
+    lf->fd = open(path, O_WRONLY);      /* No O_TRUNC: that would free the clusters again */
+    lf->capacity = prealloc_bytes;
+    FILE *f = lf_attach(lf, slot);
+    return f ? f : open_stdio(path, mode);
+}
+
+FILE *Log_File_Reopen(const char *path, uint32_t data_end)
+{
+    if (data_end == 0) {
+        return open_stdio(path, "a");
+    }
+
+    int slot;
+    log_file_t *lf = lf_new(path, &slot);
+    if (!lf) {
+        return open_stdio(path, "a");
+    }
+    lf->fd = open(path, O_RDWR);
+    off_t size = lf->fd >= 0 ? lseek(lf->fd, 0, SEEK_END) : -1;
+    lf->block_off = data_end & ~(uint32_t)(LOG_FILE_BLOCK - 1);
+    lf->fill = data_end - lf->block_off;
+    lf->capacity = size > 0 ? (uint32_t)size : 0;
+    lf->overflowed = data_end > lf->capacity;
+
+    /* Pick the partial block back up so the next write extends it in place */
+    if (lf->fd >= 0 && lf->fill > 0 &&
+        (lseek(lf->fd, (off_t)lf->block_off, SEEK_SET) < 0 || read(lf->fd, lf->block, lf->fill) != (ssize_t)lf->fill)) {
+        close(lf->fd);
+        lf->fd = -1;
+    }
+    if (size < 0 || lf->fd < 0) {
+        ESP_LOGW(TAG, "Cannot reopen %s at %lu, appending", path, (unsigned long)data_end);
+        if (lf->fd >= 0) {
+            close(lf->fd);
+        }
+        lf_free(lf);
+        return open_stdio(path, "a");
+    }
+    FILE *f = lf_attach(lf, slot);
+    return f ? f : open_stdio(path, "a");
+}
+
+int Log_File_Close_Keep(FILE *f, uint32_t *data_end)
+{
+    log_file_t *lf = find(f);
+    *data_end = 0;
+    if (lf) {
+        fflush(f);
+        *data_end = lf->block_off + lf->fill;
+        lf->keep = true;
+    }
+    return fclose(f);
+}
+
+void Log_File_Sync(FILE *f)
+{
+    fflush(f);
+    log_file_t *lf = find(f);
+    if (!lf) {
+        fsync(fileno(f));
+        return;
+    }
+    /* Size and FAT were final at open, so rewriting data sectors is the
+     * whole sync. An exactly full block leaves no padding behind the data:
+     * the next (zero) block goes out once to mark the end */
+    if (lf->dirty || !lf->terminated) {
+        put_block(lf);
+    }
+    if (lf->overflowed) {
+        fsync(lf->fd);
+    }
+}
+
+bool Log_File_Is_Prealloc(FILE *f)
+{
+    return find(f) != NULL;
+}
+
+#if LOG_FILE_BENCH
+#define BENCH_SYNCS         128         // Simulated sync periods
+#define BENCH_WRITES        16          // Writes per period
+#define BENCH_WRITE_BYTES   128         // 2 KB per period, a busy session's text + binary rate
+#define BENCH_PREALLOC      (BENCH_SYNCS * BENCH_WRITES * BENCH_WRITE_BYTES)
+
+typedef struct {
+    long long write_sum, write_max, sync_sum, sync_max, total;     // us
+} bench_result_t;
+
+static bool bench_run(const char *path, bool prealloc, bench_result_t *r)
+{
+    char rec[BENCH_WRITE_BYTES];
+    for (int i = 0; i < BENCH_WRITE_BYTES; i++) {
+        rec[i] = (char)('A' + i % 26);
+    }
+    rec[BENCH_WRITE_BYTES - 1] = '\n';
+
+    memset(r, 0, sizeof(*r));
+    int64_t t_start = esp_timer_get_time();
+    FILE *f = prealloc ? Log_File_Open(path, "w", BENCH_PREALLOC) : open_stdio(path, "w");
+    if (!f) {
+        return false;
+    }
+    for (int s = 0; s < BENCH_SYNCS; s++) {
+        for (int w = 0; w < BENCH_WRITES; w++) {
+            int64_t t0 = esp_timer_get_time();
+            fwrite(rec, sizeof(rec), 1, f);
+            int64_t dt = esp_timer_get_time() - t0;
+            r->write_sum += dt;
+            r->write_max = dt > r->write_max ? dt : r->write_max;
+        }
+        int64_t t0 = esp_timer_get_time();
+        Log_File_Sync(f);
+        int64_t dt = esp_timer_get_time() - t0;
+        r->sync_sum += dt;
+        r->sync_max = dt > r->sync_max ? dt : r->sync_max;
+    }
+    fclose(f);
+    r->total = esp_timer_get_time() - t_start;
+    unlink(path);
+    return true;
+}
+
+static void bench_report(const char *name, const bench_result_t *r)
+{
+    ESP_LOGI(TAG, "%-8s write mean %4lld us max %6lld us | sync mean %6lld us max %7lld us | total %lld ms",
+             name, r->write_sum / (BENCH_SYNCS * BENCH_WRITES), r->write_max,
+             r->sync_sum / BENCH_SYNCS, r->sync_max, r->total / 1000);
+}
+
+void Log_File_Bench(const char *dir)
+{
+    char path[300];
+    bench_result_t append, prealloc;
+
+    ESP_LOGI(TAG, "Bench: %d x %d-byte writes, sync every %d", BENCH_SYNCS * BENCH_WRITES, BENCH_WRITE_BYTES,
+             BENCH_WRITES);
+    snprintf(path, sizeof(path), "%s/bench_a.tmp", dir);
+    bool ok = bench_run(path, false, &append);
+    snprintf(path, sizeof(path), "%s/bench_p.tmp", dir);
+    ok = ok && bench_run(path, true, &prealloc);
+    if (!ok) {
+        ESP_LOGW(TAG, "Bench: could not create scratch files in %s", dir);
+        return;
+    }
+    bench_report("append", &append);
+    bench_report("prealloc", &prealloc);
+}
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/***********************
+ *  PREALLOCATED LOG FILES
+ *  Growing a FAT file with small appends allocates a cluster every
+ *  allocation unit, and every fsync rewrites the FAT and the directory
+ *  entry; on cheap cards that is where the multi-hundred-millisecond
+ *  write stalls come from. A preallocated file reserves one contiguous
+ *  run of clusters when the session starts (the only FAT update), then
+ *  takes whole LOG_FILE_BLOCK writes at block-aligned offsets, which
+ *  FatFs passes straight to the card. Log_File_Sync() rewrites the
+ *  current, zero-padded block in place: data is on the card and no
+ *  metadata sector is touched. Closing the stream truncates the file to
+ *  the bytes actually written; Log_File_Close_Keep() closes it at full
+ *  size instead, for Log_File_Reopen() to continue it later.
+ *
+ *  The stream comes from fopencookie(), so callers keep using fprintf /
+ *  fwrite / fclose. After a power cut without a close, the file keeps its
+ *  preallocated size; the data ends at the first zero padding.
+ ***********************/
+#define LOG_FILE_BLOCK          4096    // Write unit: 8 sectors, a multiple of every card's page
+#define LOG_FILE_MAX            4       // Preallocated files open at once
+#define LOG_FILE_MOUNT          "/sdcard"
+#define LOG_FILE_BENCH          0       // 1 = SD_Logger_Init() times append vs preallocated writes first
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * Open a log file.
+ * @param mode            "w" to create, "a" to append
+ * @param prealloc_bytes  Contiguous size to reserve for a new file. 0, mode
+ *                        "a", or a failed reservation give a plain stdio
+ *                        stream with a LOG_FILE_BLOCK buffer
+ * @return Stream for fprintf / fwrite / fclose, NULL on error
+ */
+FILE *Log_File_Open(const char *path, const char *mode, uint32_t prealloc_bytes);
+
+/**
+ * Continue a file closed by Log_File_Close_Keep() in preallocated mode,
+ * writing from data_end on (the partial block there is read back).
+ * @param data_end  Offset returned by Log_File_Close_Keep(); 0 (the file
+ *                  was a plain stream) or any failure give a stdio append
+ * @return Stream for fprintf / fwrite / fclose, NULL on error
+ */
+FILE *Log_File_Reopen(const char *path, uint32_t data_end);
+
+/**
+ * Close a stream like fclose(), but keep a preallocated file at its full,
+ * zero-padded size so it can be reopened without new cluster allocation.
+ * @param data_end  Filled with the end of the data, 0 for a plain stream
+ * @return fclose() result
+ */
+int Log_File_Close_Keep(FILE *f, uint32_t *data_end);
+
+/**
+ * Put everything written so far on the card: fflush + fsync for a plain
+ * stream, fflush + an in-place rewrite of the current block for a
+ * preallocated one.
+ */
+void Log_File_Sync(FILE *f);
+
+/** @return true if f was opened preallocated */
+bool Log_File_Is_Prealloc(FILE *f);
+
+#if LOG_FILE_BENCH
+/**
+ * Write the same record pattern through the append path and the
+ * preallocated path in dir and log per-write and per-sync latency
+ * (mean / max) for both. Scratch files are deleted afterwards.
+ */
+void Log_File_Bench(const char *dir);
+#endif
@@ -0,0 +1,71 @@
+#include "Log_Index.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Telemetry.h"
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Log_Index_Init(log_index_t *idx, uint32_t next_seq)
+{
+    memset(idx, 0, sizeof(*idx));
+    memcpy(idx->magic, LOG_INDEX_MAGIC, sizeof(idx->magic));
+    idx->version = LOG_INDEX_VERSION;
+    idx->next_seq = next_seq;
+}
+
+void Log_Index_Seal(log_index_t *idx)
+{
+    idx->crc = Telemetry_Crc16(idx, offsetof(log_index_t, crc));
+}
+
+bool Log_Index_Check(const log_index_t *idx)
+{
+    return memcmp(idx->magic, LOG_INDEX_MAGIC, sizeof(idx->magic)) == 0 &&
+           idx->version == LOG_INDEX_VERSION &&
+           idx->count <= LOG_INDEX_SLOTS && idx->first < LOG_INDEX_SLOTS &&
+           idx->crc == Telemetry_Crc16(idx, offsetof(log_index_t, crc));
+}
+
+log_index_entry_t *Log_Index_At(log_index_t *idx, uint16_t i)
+{
+    if (i >= idx->count) {
+        return NULL;
+    }
+    return &idx->slot[(idx->first + i) % LOG_INDEX_SLOTS];
+}
+
+log_index_entry_t *Log_Index_Push(log_index_t *idx, uint32_t seq, int64_t start_epoch_us)
+{
+    if (idx->count == LOG_INDEX_SLOTS) {
+        return NULL;
+    }
+    log_index_entry_t *e = &idx->slot[(idx->first + idx->count) % LOG_INDEX_SLOTS];
+    idx->count++;
+    memset(e, 0, sizeof(*e));
+    e->seq = seq;
+    e->start_epoch_us = start_epoch_us;
+    if (seq >= idx->next_seq) {
+        idx->next_seq = seq + 1;
+    }
+    return e;
+}
+
+void Log_Index_Pop(log_index_t *idx)
+{
+    if (idx->count) {
+        idx->first = (uint16_t)((idx->first + 1) % LOG_INDEX_SLOTS);
+        idx->count--;
+    }
+}
+
+uint64_t Log_Index_Bytes(const log_index_t *idx)
+{
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < idx->count; i++) {
+        total += idx->slot[(idx->first + i) % LOG_INDEX_SLOTS].bytes;
+    }
+    return total;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/***********************
+ *  LOG SESSION INDEX
+ *  The retained log sessions (L/T/D%05d files sharing one number) and the
+ *  next number to use, kept in one small file next to them so that
+ *  starting a session costs one read and one write instead of directory
+ *  scans. Sessions form a ring, oldest first: a new session is pushed at
+ *  the end, rotation pops from the front. A CRC-16/CCITT-FALSE
+ *  (Telemetry_Crc16) covers everything before it; an index that fails
+ *  Log_Index_Check() is rebuilt from the directory by the caller.
+ *  Packed, little-endian, plain C with no ESP-IDF dependencies.
+ *
+ *  Bump LOG_INDEX_VERSION whenever the layout changes.
+ ***********************/
+#define LOG_INDEX_MAGIC         "ICLX"
+#define LOG_INDEX_VERSION       1
+#define LOG_INDEX_SLOTS         32          // Sessions tracked; older ones must already be deleted
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct __attribute__((packed)) {
+    uint32_t seq;               // File number
+    uint32_t bytes;             // L + T + D size on the card, 0 = not known yet (session still open)
+    int64_t  start_epoch_us;    // Wall clock at session start, 0 if the RTC was not set
+    int64_t  end_epoch_us;      // Last update while running or at close, 0 if never
+} log_index_entry_t;
+
+typedef struct __attribute__((packed)) {
+    char     magic[4];          // LOG_INDEX_MAGIC
+    uint16_t version;           // LOG_INDEX_VERSION
+    uint16_t count;             // Sessions in the ring
+    uint16_t first;             // Slot of the oldest
+    uint16_t reserved;
+    uint32_t next_seq;          // Number for the next session; never reused
+    log_index_entry_t slot[LOG_INDEX_SLOTS];
+    uint16_t crc;
+} log_index_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Empty index whose first session will be next_seq */
+void Log_Index_Init(log_index_t *idx, uint32_t next_seq);
+
+/** Fill in the CRC before writing idx out */
+void Log_Index_Seal(log_index_t *idx);
+
+/** @return true if idx has the magic, this version, a consistent ring and a good CRC */
+bool Log_Index_Check(const log_index_t *idx);
+
+/** @return The i-th session, 0 = oldest, NULL past the end */
+log_index_entry_t *Log_Index_At(log_index_t *idx, uint16_t i);
+
+/**
+ * Append a session as the newest and move next_seq past it.
+ * @return The new entry (stays valid until it is popped), NULL if the ring is full
+ */
+log_index_entry_t *Log_Index_Push(log_index_t *idx, uint32_t seq, int64_t start_epoch_us);
+
+/** Forget the oldest session (its files are the caller's to delete) */
+void Log_Index_Pop(log_index_t *idx);
+
+/** @return Sum of the known session sizes */
+uint64_t Log_Index_Bytes(const log_index_t *idx);
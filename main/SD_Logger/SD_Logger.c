@@ -7,26 +7,89 @@
 #include <sys/stat.h>
 #include <sys/unistd.h>
 #include <errno.h>
+#include <stdatomic.h>
 
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_app_desc.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
-#include "freertos/timers.h"
+
+#include "esp_timer.h"
+#include "Sensor_Ring.h"
+#include "I2C_Driver.h"
+#include "PCF85063.h"
+#include "QMI8658.h"
+#include "Telemetry.h"
+#include "Log_Defer.h"
+#include "Log_File.h"
+#include "Log_Index.h"
+#include "Thermistor.h"
+#include "BAT_Driver.h"
+#include "Spray.h"
+#include "screen_trigger_temp.h"
+#include "screen_spray_duration.h"
+#include "screen_spray_interval.h"
 
 /* --------------- configuration --------------- */
 #define SD_LOG_DIR      "/sdcard/system/logs"
 #define SD_LOG_PREFIX   "L"
 #define SD_LOG_EXT      ".txt"
-#define SD_LOG_MAX_KEEP 5          /* number of log files to retain */
+#define SD_TLM_PREFIX   "T"        /* binary telemetry, same number as the text log */
+#define SD_TLM_EXT      ".bin"
+#define SD_DLOG_PREFIX  "D"        /* deferred (unformatted) ESP_LOG output, same number */
+#define SD_DLOG_EXT     ".bin"
+#define SD_LOG_PREALLOC_TEXT  (1 * 1024 * 1024)  /* contiguous reservation of each new text log (Log_File.h) */
+#define SD_LOG_PREALLOC_BIN   (4 * 1024 * 1024)  /* ... and of each T / D file, ~3 h of telemetry */
+#define SD_LOG_DEFERRED       1            /* 1 = store ESP_LOG calls unformatted (Log_Defer.h), 0 = as text */
+#define SD_LOG_UART_ECHO      0            /* 1 = also print deferred I/D/V ESP_LOG calls (W and E always print) */
+#define SD_LOG_TEXT_SAMPLES   0            /* 1 = also write every sensor sample as an "S,..." text line */
+#define SD_LOG_MAX_KEEP 5          /* number of log sessions to retain */
+#define SD_LOG_MAX_BYTES      (256u * 1024 * 1024)  /* ... and their total size, 0 = no limit */
+#define SD_LOG_MAX_AGE_DAYS   0            /* ... and their age (needs the RTC set), 0 = no limit */
+#define SD_LOG_INDEX          SD_LOG_DIR "/INDEX.BIN"   /* session index (Log_Index.h) */
+#define SD_LOG_INDEX_TMP      SD_LOG_DIR "/INDEX.TMP"
+#define SD_LOG_INDEX_EVERY    600          /* syncs between index updates (session end time) */
+#define SD_LOG_EPOCH_VALID_US (1577836800LL * 1000000)  /* RTC earlier than 2020: never set */
+#define SD_LOG_I2C_EVERY 60        /* syncs between I2C / logger statistics lines */
+#define SD_LOG_RING_BYTES     (64 * 1024)  /* log line ring in PSRAM, power of two */
+#define SD_LOG_RING_FALLBACK  (8 * 1024)   /* internal RAM if PSRAM is unavailable */
+#define SD_LOG_LINE_MAX       512          /* longest line kept, the rest is truncated */
+#define SD_LOG_DRAIN_MS       100          /* writer wakes at least this often */
+#define SD_LOG_TASK_PRIORITY  1            /* below every driver and the UI */
+#define SD_LOG_TASK_STACK     4096
+
+_Static_assert((SD_LOG_RING_BYTES & (SD_LOG_RING_BYTES - 1)) == 0, "SD_LOG_RING_BYTES must be a power of two");
+_Static_assert((SD_LOG_RING_FALLBACK & (SD_LOG_RING_FALLBACK - 1)) == 0, "SD_LOG_RING_FALLBACK must be a power of two");
+_Static_assert(SD_LOG_MAX_KEEP >= 1 && SD_LOG_MAX_KEEP <= LOG_INDEX_SLOTS, "SD_LOG_MAX_KEEP must fit in the index");
+_Static_assert(sizeof(SD_LOG_PREFIX) == sizeof(SD_TLM_PREFIX) && sizeof(SD_LOG_PREFIX) == sizeof(SD_DLOG_PREFIX),
+               "session file prefixes must have the same length");
 
 static const char *TAG = "SD_Logger";
 
 /* --------------- state ----------------------- */
 static FILE              *s_log_file    = NULL;
 static vprintf_like_t     s_orig_vprintf = NULL;   /* original log handler */
-static SemaphoreHandle_t  s_log_mutex   = NULL;
-static TimerHandle_t      s_sync_timer  = NULL;
+static SemaphoreHandle_t  s_log_mutex   = NULL;    /* file access: writer task vs Flush/Suspend/Resume */
+static TaskHandle_t       s_writer_task = NULL;
+static TickType_t         s_sync_ticks  = 0;
+static atomic_bool        s_stop        = false;
 static bool               s_dirty       = false;   /* true if writes since last sync */
+static sensor_reader_t    s_sensor_reader;          /* logger's own sensor ring cursor */
+static char               s_log_path[300];          /* current file, for reopening after a suspend */
+static FILE              *s_tlm_file    = NULL;    /* binary telemetry (Telemetry.h), under s_log_mutex */
+static char               s_tlm_path[300];
+static uint16_t           s_tlm_seq     = 0;
+static FILE              *s_dlog_file   = NULL;    /* deferred log entries, under s_log_mutex */
+static char               s_dlog_path[300];
+static uint32_t           s_log_end     = 0;        /* data end of each file while suspended, */
+static uint32_t           s_tlm_end     = 0;        /* 0 = plain stream (Log_File_Close_Keep) */
+static uint32_t           s_dlog_end    = 0;
+static uint32_t           s_probe_fault = 0;        /* channels with SENSOR_FLAG_FAULT in the last sample */
+static log_index_t        s_index;                  /* retained sessions, mirrors SD_LOG_INDEX */
+static log_index_entry_t *s_session     = NULL;    /* this session's entry in s_index */
 
 /* --------------- helpers --------------------- */
 
@@ -45,127 +108,734 @@ static void mkdirs(const char *path)
     mkdir(tmp, 0775);
 }
 
-/** Comparison for qsort – sort filenames ascending (oldest first). */
-static int cmp_str(const void *a, const void *b)
+/** Comparison for qsort – session numbers ascending (oldest first). */
+static int cmp_seq(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/** RTC wall clock, 0 while it has not been set */
+static int64_t epoch_now(void)
+{
+    int64_t us = RTC_Get_Epoch_Us();
+    return us >= SD_LOG_EPOCH_VALID_US ? us : 0;
+}
+
+static void session_path(char *out, size_t len, const char *prefix, uint32_t seq, const char *ext)
 {
-    return strcmp(*(const char **)a, *(const char **)b);
+    snprintf(out, len, "%s/%s%05lu%s", SD_LOG_DIR, prefix, (unsigned long)seq, ext);
+}
+
+/** Size of a session's L + T + D files on the card */
+static uint32_t session_bytes(uint32_t seq)
+{
+    static const char *const names[3][2] = {
+        { SD_LOG_PREFIX, SD_LOG_EXT }, { SD_TLM_PREFIX, SD_TLM_EXT }, { SD_DLOG_PREFIX, SD_DLOG_EXT },
+    };
+    uint32_t total = 0;
+    for (int i = 0; i < 3; i++) {
+        char full[300];
+        struct stat st;
+        session_path(full, sizeof(full), names[i][0], seq, names[i][1]);
+        if (stat(full, &st) == 0) {
+            total += (uint32_t)st.st_size;
+        }
+    }
+    return total;
+}
+
+static void session_delete(uint32_t seq)
+{
+    char full[300];
+    ESP_LOGI(TAG, "Deleting old log: %s%05lu", SD_LOG_PREFIX, (unsigned long)seq);
+    session_path(full, sizeof(full), SD_LOG_PREFIX, seq, SD_LOG_EXT);
+    unlink(full);
+    session_path(full, sizeof(full), SD_TLM_PREFIX, seq, SD_TLM_EXT);
+    unlink(full);
+    session_path(full, sizeof(full), SD_DLOG_PREFIX, seq, SD_DLOG_EXT);
+    unlink(full);
 }
 
 /**
- * Scan the log directory, build a sorted list of existing log files,
- * delete the oldest ones so that at most (SD_LOG_MAX_KEEP - 1) remain
- * (leaving room for the new file we are about to create).
+ * Write s_index through a temporary file that replaces the old index only
+ * once it is complete (same scheme as settings_save()). A cut in between
+ * leaves either file intact, and index_load() picks up the temporary one.
  */
-static void rotate_logs(void)
+static bool index_save(void)
 {
-    DIR *dir = opendir(SD_LOG_DIR);
-    if (!dir) return;
+    Log_Index_Seal(&s_index);
+    FILE *f = fopen(SD_LOG_INDEX_TMP, "wb");
+    if (!f) {
+        ESP_LOGW(TAG, "Failed to open %s (errno %d)", SD_LOG_INDEX_TMP, errno);
+        return false;
+    }
+    bool ok = fwrite(&s_index, sizeof(s_index), 1, f) == 1;
+    fflush(f);
+    fsync(fileno(f));
+    ok = (fclose(f) == 0) && ok;
+    /* FAT rename does not replace an existing file */
+    unlink(SD_LOG_INDEX);
+    if (!ok || rename(SD_LOG_INDEX_TMP, SD_LOG_INDEX) != 0) {
+        ESP_LOGW(TAG, "Failed to write %s (errno %d)", SD_LOG_INDEX, errno);
+        return false;
+    }
+    return true;
+}
+
+static bool index_load(void)
+{
+    FILE *f = fopen(SD_LOG_INDEX, "rb");
+    if (!f && rename(SD_LOG_INDEX_TMP, SD_LOG_INDEX) == 0) {
+        ESP_LOGW(TAG, "Recovered log index from %s", SD_LOG_INDEX_TMP);
+        f = fopen(SD_LOG_INDEX, "rb");
+    }
+    if (!f) {
+        return false;
+    }
+    bool ok = fread(&s_index, sizeof(s_index), 1, f) == 1 && Log_Index_Check(&s_index);
+    fclose(f);
+    return ok;
+}
+
+/**
+ * Missing or corrupt index: one pass over the log directory collects every
+ * session number (L, T or D file), the newest LOG_INDEX_SLOTS are indexed
+ * with their sizes and anything older is deleted, as it could never be
+ * rotated out otherwise. Start times of rebuilt sessions are unknown.
+ */
+static void index_rebuild(void)
+{
+    uint32_t *seqs = NULL;
+    size_t count = 0, cap = 0;
+    uint32_t max_seq = 0;
 
-    /* Collect matching filenames */
-    char *names[64];
-    int   count = 0;
+    DIR *dir = opendir(SD_LOG_DIR);
     struct dirent *ent;
-    while ((ent = readdir(dir)) != NULL && count < 64) {
-        if (strncmp(ent->d_name, SD_LOG_PREFIX, strlen(SD_LOG_PREFIX)) == 0) {
-            names[count] = strdup(ent->d_name);
-            if (names[count]) count++;
+    while (dir && (ent = readdir(dir)) != NULL) {
+        const char *n = ent->d_name;
+        if (strncmp(n, SD_LOG_PREFIX, strlen(SD_LOG_PREFIX)) != 0 &&
+            strncmp(n, SD_TLM_PREFIX, strlen(SD_TLM_PREFIX)) != 0 &&
+            strncmp(n, SD_DLOG_PREFIX, strlen(SD_DLOG_PREFIX)) != 0) {
+            continue;
+        }
+        const char *digits = n + strlen(SD_LOG_PREFIX);
+        char *end;
+        unsigned long seq = strtoul(digits, &end, 10);
+        if (end - digits != 5 || *end != '.') {
+            continue;
+        }
+        if (count == cap) {
+            uint32_t *grown = realloc(seqs, (cap ? cap * 2 : 64) * sizeof(*seqs));
+            if (!grown) {
+                break;
+            }
+            seqs = grown;
+            cap = cap ? cap * 2 : 64;
+        }
+        seqs[count++] = (uint32_t)seq;
+        if (seq > max_seq) {
+            max_seq = (uint32_t)seq;
         }
     }
-    closedir(dir);
-
-    if (count == 0) return;
+    if (dir) {
+        closedir(dir);
+    }
 
-    /* Sort ascending so oldest (smallest number) is first */
-    qsort(names, count, sizeof(char *), cmp_str);
+    qsort(seqs, count, sizeof(*seqs), cmp_seq);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || seqs[i] != seqs[unique - 1]) {
+            seqs[unique++] = seqs[i];
+        }
+    }
 
-    /* Delete oldest files, keep at most (MAX_KEEP - 1) */
-    int to_delete = count - (SD_LOG_MAX_KEEP - 1);
-    for (int i = 0; i < count; i++) {
-        if (i < to_delete) {
-            char full[300];
-            snprintf(full, sizeof(full), "%s/%s", SD_LOG_DIR, names[i]);
-            ESP_LOGI(TAG, "Deleting old log: %s", names[i]);
-            unlink(full);
+    Log_Index_Init(&s_index, max_seq + 1);
+    size_t keep_from = unique > LOG_INDEX_SLOTS ? unique - LOG_INDEX_SLOTS : 0;
+    for (size_t i = 0; i < unique; i++) {
+        if (i < keep_from) {
+            session_delete(seqs[i]);
+        } else {
+            Log_Index_Push(&s_index, seqs[i], 0)->bytes = session_bytes(seqs[i]);
         }
-        free(names[i]);
     }
+    free(seqs);
+    ESP_LOGW(TAG, "Log index rebuilt from directory: %u sessions, next #%lu", (unsigned)s_index.count,
+             (unsigned long)s_index.next_seq);
 }
 
 /**
- * Find the next log sequence number by scanning existing files.
+ * Bring the index up to date and delete the oldest sessions until, with
+ * room for the new one, at most SD_LOG_MAX_KEEP remain, they fit in
+ * SD_LOG_MAX_BYTES and none is older than SD_LOG_MAX_AGE_DAYS. Each
+ * deletion is O(1): its number and size come from the index.
  */
-static int next_sequence(void)
+static void rotate_logs(void)
 {
-    DIR *dir = opendir(SD_LOG_DIR);
-    if (!dir) return 1;
+    if (!index_load()) {
+        index_rebuild();
+    }
 
-    int max_seq = 0;
-    struct dirent *ent;
-    while ((ent = readdir(dir)) != NULL) {
-        if (strncmp(ent->d_name, SD_LOG_PREFIX, strlen(SD_LOG_PREFIX)) == 0) {
-            int seq = atoi(ent->d_name + strlen(SD_LOG_PREFIX));
-            if (seq > max_seq) max_seq = seq;
+    /* The previous session ended by power-off, not Deinit: size what it left */
+    log_index_entry_t *last = Log_Index_At(&s_index, s_index.count - 1);
+    if (last && last->bytes == 0) {
+        last->bytes = session_bytes(last->seq);
+    }
+
+    int64_t now = epoch_now();
+    log_index_entry_t *old;
+    while ((old = Log_Index_At(&s_index, 0)) != NULL) {
+        int64_t ended = old->end_epoch_us ? old->end_epoch_us : old->start_epoch_us;
+        bool over_count = s_index.count > SD_LOG_MAX_KEEP - 1;
+        bool over_bytes = SD_LOG_MAX_BYTES && Log_Index_Bytes(&s_index) > SD_LOG_MAX_BYTES;
+        bool too_old = SD_LOG_MAX_AGE_DAYS && now && ended &&
+                       now - ended > (int64_t)SD_LOG_MAX_AGE_DAYS * 86400 * 1000000;
+        if (!over_count && !over_bytes && !too_old) {
+            break;
         }
+        session_delete(old->seq);
+        Log_Index_Pop(&s_index);
     }
-    closedir(dir);
-    return max_seq + 1;
 }
 
-/* Helper: flush C buffer AND sync FAT to SD card */
+/** Session end time into the index while running; a power-off keeps the last one */
+static void index_touch(void)
+{
+    if (s_session) {
+        s_session->end_epoch_us = epoch_now();
+        index_save();
+    }
+}
+
+/* Helper: flush C buffers and put the data on the SD card */
 static void sd_flush_sync(void)
 {
     if (s_log_file) {
-        fflush(s_log_file);
-        fsync(fileno(s_log_file));
+        Log_File_Sync(s_log_file);
         s_dirty = false;
     }
+    if (s_tlm_file) {
+        Log_File_Sync(s_tlm_file);
+    }
+    if (s_dlog_file) {
+        Log_File_Sync(s_dlog_file);
+    }
 }
 
-/* Timer callback — runs every sync_interval_ms from FreeRTOS timer task */
-static void sync_timer_cb(TimerHandle_t xTimer)
+/** Close *f if open. @return fclose() result, 0 if it was not open */
+static int bin_close(FILE **f)
 {
-    (void)xTimer;
-    if (s_log_file && s_log_mutex && s_dirty) {
-        if (xSemaphoreTake(s_log_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-            sd_flush_sync();
-            xSemaphoreGive(s_log_mutex);
+    int ret = 0;
+    if (*f) {
+        ret = fclose(*f);
+        *f = NULL;
+    }
+    return ret;
+}
+
+/** Close for a suspend: the preallocation stays, *end is where Resume continues */
+static int suspend_close(FILE **f, uint32_t *end)
+{
+    int ret = 0;
+    *end = 0;
+    if (*f) {
+        ret = Log_File_Close_Keep(*f, end);
+        *f = NULL;
+    }
+    return ret;
+}
+
+/** Seal and append one telemetry record. Caller holds s_log_mutex */
+static void tlm_write(tlm_record_t *r)
+{
+    if (s_tlm_file) {
+        Telemetry_Seal(r, s_tlm_seq++);
+        fwrite(r, sizeof(*r), 1, s_tlm_file);
+        s_dirty = true;
+    }
+}
+
+/**
+ * Append every sensor sample published since the last call as a
+ * TLM_TYPE_SENSOR record, plus a TLM_HEALTH_PROBE_FAULT / _OK record
+ * whenever a channel's latched fault changes. With SD_LOG_TEXT_SAMPLES
+ * each sample is also written as an "S,timestamp_us" line followed by
+ * ",raw_mv,temp_centi_c,flags" for each of the SENSOR_MAX_CHANNELS
+ * channels, then ",supply_mv". Integer-only so it is safe on the writer
+ * task stack. Caller holds s_log_mutex.
+ */
+static void write_sensor_samples(void)
+{
+    sensor_sample_t samples[8];
+    tlm_record_t rec;
+    size_t n;
+    while ((n = Sensor_Ring_Read(&s_sensor_reader, samples, sizeof(samples) / sizeof(samples[0]))) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            Telemetry_Sensor(&rec, &samples[i]);
+            tlm_write(&rec);
+            for (int ch = 0; ch < SENSOR_MAX_CHANNELS; ch++) {
+                uint32_t fault = (samples[i].flags[ch] & SENSOR_FLAG_FAULT) ? (1u << ch) : 0;
+                if (fault != (s_probe_fault & (1u << ch))) {
+                    s_probe_fault ^= 1u << ch;
+                    Telemetry_Health(&rec, samples[i].timestamp_us,
+                                     fault ? TLM_HEALTH_PROBE_FAULT : TLM_HEALTH_PROBE_OK, (uint8_t)ch,
+                                     samples[i].raw_mv[ch], samples[i].flags[ch]);
+                    tlm_write(&rec);
+                }
+            }
+#if SD_LOG_TEXT_SAMPLES
+            fprintf(s_log_file, "S,%lld", (long long)samples[i].timestamp_us);
+            for (int ch = 0; ch < SENSOR_MAX_CHANNELS; ch++) {
+                fprintf(s_log_file, ",%ld,%ld,%lu", (long)samples[i].raw_mv[ch],
+                        (long)(samples[i].temp_c[ch] * 100.0f), (unsigned long)samples[i].flags[ch]);
+            }
+            fprintf(s_log_file, ",%ld\n", (long)samples[i].supply_mv);
+#endif
+        }
+        s_dirty = true;
+    }
+}
+
+/** Append a TLM_TYPE_CONTROL snapshot of the spray engine and settings. Caller holds s_log_mutex */
+static void write_control_state(void)
+{
+    spray_stats_t stats;
+    Spray_GetStats(&stats);
+    tlm_control_t c = {
+        .mode = (uint8_t)Spray_GetMode(),
+        .state = (uint8_t)Spray_GetState(),
+        .flags = (Spray_IsEnabled() ? TLM_CTRL_ENABLED : 0) | (Spray_IsTankEmpty() ? TLM_CTRL_TANK_EMPTY : 0) |
+                 (Spray_SensorFault() ? TLM_CTRL_SENSOR_FAULT : 0) | (BAT_Brownout() ? TLM_CTRL_BROWNOUT : 0),
+        .trigger_centi_c = (int16_t)(g_trigger_temperature * 100),
+        .duty_permille = (uint16_t)(Spray_GetDuty() * 1000.0f + 0.5f),
+        .duration_ms = (uint16_t)(g_sprayer_duration * 1000.0f + 0.5f),
+        .interval_s = (uint16_t)g_sprayer_interval,
+        .cycles = stats.cycles,
+    };
+    tlm_record_t rec;
+    Telemetry_Control(&rec, esp_timer_get_time(), &c);
+    tlm_write(&rec);
+}
+
+/**
+ * Append one "I,timestamp_us,addr,..." line per I2C device with its
+ * cumulative bus statistics (see the header comment for the fields).
+ * Caller holds s_log_mutex.
+ */
+static void write_i2c_stats(void)
+{
+    static i2c_dev_stats_t stats[8];
+    int n = I2C_Get_Stats(stats, sizeof(stats) / sizeof(stats[0]));
+    long long now = (long long)esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        const i2c_dev_stats_t *s = &stats[i];
+        fprintf(s_log_file, "I,%lld,0x%02X,%lu,%lu,%lu,%lu,%lu,%lu,%llu,%lu", now, s->addr,
+                (unsigned long)s->txns, (unsigned long)s->transfers, (unsigned long)s->bytes_tx,
+                (unsigned long)s->bytes_rx, (unsigned long)s->errors, (unsigned long)s->retries,
+                (unsigned long long)s->busy_us, (unsigned long)s->lat_max_us);
+        for (int b = 0; b < I2C_LAT_BUCKETS; b++) {
+            fprintf(s_log_file, ",%lu", (unsigned long)s->lat_hist[b]);
+        }
+        fputc('\n', s_log_file);
+    }
+    if (n > 0) {
+        s_dirty = true;
+    }
+}
+
+#if IMU_FIFO_ENABLE
+static uint32_t s_vibe_cursor = 0;
+
+/**
+ * Append one "V,timestamp_us,frames,..." line per IMU vibration summary
+ * published since the last call: per-axis RMS in mg, peak |a| in mg,
+ * per-axis gyro RMS in mdps, then the |a| band amplitudes in mg.
+ * Caller holds s_log_mutex.
+ */
+static void write_vibe_summaries(void)
+{
+    imu_vibe_t v[2];
+    size_t n;
+    while ((n = QMI8658_Vibe_Read(&s_vibe_cursor, v, sizeof(v) / sizeof(v[0]))) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            fprintf(s_log_file, "V,%lld,%u,%ld,%ld,%ld,%ld,%ld,%ld,%ld", (long long)v[i].timestamp_us,
+                    (unsigned)v[i].frames, (long)(v[i].acc_rms_g[0] * 1000.0f),
+                    (long)(v[i].acc_rms_g[1] * 1000.0f), (long)(v[i].acc_rms_g[2] * 1000.0f),
+                    (long)(v[i].acc_peak_g * 1000.0f), (long)(v[i].gyro_rms_dps[0] * 1000.0f),
+                    (long)(v[i].gyro_rms_dps[1] * 1000.0f), (long)(v[i].gyro_rms_dps[2] * 1000.0f));
+            for (int b = 0; b < IMU_VIBE_BINS; b++) {
+                fprintf(s_log_file, ",%ld", (long)(v[i].band_g[b] * 1000.0f));
+            }
+            fputc('\n', s_log_file);
         }
+        s_dirty = true;
     }
 }
+#endif
+
+/* --------------- line ring ------------------- */
+
+/*
+ * Multi-producer, single-consumer byte ring between the ESP_LOGx callers and
+ * the writer task. A producer reserves [head, head + span) with one CAS on
+ * s_ring_head, copies its line in and publishes it by storing the length into
+ * the record's 4-byte header; it never waits for the card or for another
+ * producer. The writer (or Flush, both under s_log_mutex) consumes committed
+ * records in order, zeroes them and advances s_ring_tail. A reserved but not
+ * yet committed record still reads 0 and holds the writer back until it is
+ * published. The counters live in internal RAM because the S3 cannot do
+ * atomic read-modify-write on PSRAM; the ring itself only sees plain
+ * loads/stores. If the line does not fit, it is dropped and counted.
+ * Telemetry records (SD_Logger_Record) share the ring with REC_BINARY set
+ * in their header and go to the T .bin file instead; deferred log entries
+ * carry REC_DEFERRED and go to the D .bin file.
+ */
+static uint8_t    *s_ring       = NULL;
+static uint32_t    s_ring_mask  = 0;
+static atomic_uint s_ring_head  = 0;        /* bytes reserved so far */
+static atomic_uint s_ring_tail  = 0;        /* bytes consumed so far */
+static atomic_uint s_ring_hwm   = 0;        /* most bytes ever in use */
+static atomic_uint s_drop_lines = 0;
+static atomic_uint s_drop_bytes = 0;
+static uint32_t    s_lines      = 0;        /* written by the consumer only */
+static uint32_t    s_bytes      = 0;
+static uint32_t    s_drop_seen  = 0;        /* s_drop_lines already reported in the file */
+
+#define REC_HDR         4u
+#define REC_BINARY      0x80000000u     /* header flag: tlm_record_t, not text */
+#define REC_DEFERRED    0x40000000u     /* header flag: Log_Defer entry, not text */
+#define REC_FLAGS       (REC_BINARY | REC_DEFERRED)
+#define REC_SPAN(len)   ((REC_HDR + (uint32_t)(len) + 3u) & ~3u)
+
+/** Copy len bytes into the ring at pos, wrapping at the end */
+static void ring_put(uint32_t pos, const void *src, uint32_t len)
+{
+    uint32_t off = pos & s_ring_mask;
+    uint32_t first = s_ring_mask + 1u - off;
+    if (first > len) first = len;
+    memcpy(s_ring + off, src, first);
+    memcpy(s_ring, (const uint8_t *)src + first, len - first);
+}
+
+/** Copy len bytes out of the ring at pos, wrapping at the end */
+static void ring_get(uint32_t pos, void *dst, uint32_t len)
+{
+    uint32_t off = pos & s_ring_mask;
+    uint32_t first = s_ring_mask + 1u - off;
+    if (first > len) first = len;
+    memcpy(dst, s_ring + off, first);
+    memcpy((uint8_t *)dst + first, s_ring, len - first);
+}
+
+/** Queue one formatted line (or a record with REC_BINARY). Lock-free, never blocks */
+static void ring_push(const void *data, uint32_t len, uint32_t flags)
+{
+    uint32_t span = REC_SPAN(len);
+    uint32_t size = s_ring_mask + 1u;
+    uint32_t head = atomic_load_explicit(&s_ring_head, memory_order_relaxed);
+    uint32_t used;
+    do {
+        used = head - atomic_load_explicit(&s_ring_tail, memory_order_acquire);
+        if (used + span > size) {
+            atomic_fetch_add_explicit(&s_drop_lines, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&s_drop_bytes, len, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&s_ring_head, &head, head + span,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    /* Headers are 4-aligned and the size is a multiple of 4, so a header never wraps */
+    ring_put(head + REC_HDR, data, len);
+    atomic_store_explicit((atomic_uint *)(s_ring + (head & s_ring_mask)), len | flags, memory_order_release);
+
+    uint32_t hwm = atomic_load_explicit(&s_ring_hwm, memory_order_relaxed);
+    while (used + span > hwm &&
+           !atomic_compare_exchange_weak_explicit(&s_ring_hwm, &hwm, used + span,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    /* Wake the writer early when this line takes the ring past half full */
+    if (used < size / 2u && used + span >= size / 2u && s_writer_task && !xPortInIsrContext()) {
+        xTaskNotifyGive(s_writer_task);
+    }
+}
+
+/**
+ * Write every committed line / record to its file in order and release its
+ * space. Entries are counted but not written if the file is closed. Caller
+ * holds s_log_mutex, which makes it the only consumer.
+ */
+static void ring_drain(void)
+{
+    uint32_t tail = atomic_load_explicit(&s_ring_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&s_ring_head, memory_order_acquire);
+    while (tail != head) {
+        atomic_uint *hdr = (atomic_uint *)(s_ring + (tail & s_ring_mask));
+        uint32_t len = atomic_load_explicit(hdr, memory_order_acquire);
+        if (len == 0) {
+            break;                              /* Reserved, producer still copying */
+        }
+        uint32_t kind = len & REC_FLAGS;
+        len &= ~REC_FLAGS;
+        uint32_t span = REC_SPAN(len);
+        uint32_t off = (tail + REC_HDR) & s_ring_mask;
+        uint32_t first = s_ring_mask + 1u - off;
+        if (first > len) first = len;
+        if (kind == REC_BINARY) {
+            tlm_record_t rec;
+            ring_get(tail + REC_HDR, &rec, sizeof(rec));
+            tlm_write(&rec);
+        } else {
+            FILE *f = kind == REC_DEFERRED ? s_dlog_file : s_log_file;
+            if (f) {
+                fwrite(s_ring + off, 1, first, f);
+                if (len > first) {
+                    fwrite(s_ring, 1, len - first, f);
+                }
+                s_dirty = true;
+            }
+            s_lines++;
+            s_bytes += len;
+        }
+
+        /* Zero the whole span: a later header may land anywhere inside it */
+        off = tail & s_ring_mask;
+        first = s_ring_mask + 1u - off;
+        if (first > span) first = span;
+        memset(s_ring + off, 0, first);
+        memset(s_ring, 0, span - first);
+
+        tail += span;
+        atomic_store_explicit(&s_ring_tail, tail, memory_order_release);
+    }
+
+    uint32_t dropped = atomic_load_explicit(&s_drop_lines, memory_order_relaxed);
+    if (dropped != s_drop_seen && s_log_file) {
+        fprintf(s_log_file, "=== %lu log lines dropped (ring full) ===\n", (unsigned long)(dropped - s_drop_seen));
+        tlm_record_t rec;
+        Telemetry_Health(&rec, esp_timer_get_time(), TLM_HEALTH_LOG_DROP, 0xFF, (int32_t)(dropped - s_drop_seen), 0);
+        tlm_write(&rec);
+        s_drop_seen = dropped;
+        s_dirty = true;
+    }
+}
+
+/**
+ * Append one "R,timestamp_us,lines,bytes,dropped_lines,dropped_bytes,
+ * high_water,ring_bytes" line with the cumulative log ring statistics.
+ * Caller holds s_log_mutex.
+ */
+static void write_ring_stats(void)
+{
+    sd_log_stats_t st;
+    SD_Logger_Get_Stats(&st);
+    fprintf(s_log_file, "R,%lld,%lu,%lu,%lu,%lu,%lu,%lu\n", (long long)esp_timer_get_time(),
+            (unsigned long)st.lines, (unsigned long)st.bytes, (unsigned long)st.dropped_lines,
+            (unsigned long)st.dropped_bytes, (unsigned long)st.high_water, (unsigned long)st.ring_bytes);
+    s_dirty = true;
+}
+
+/* --------------- writer task ----------------- */
+
+/**
+ * The only task that touches the card during normal logging. Drains the
+ * line ring every SD_LOG_DRAIN_MS (or as soon as it is half full), and every
+ * sync interval appends the sensor / vibration / statistics lines and
+ * syncs. Runs below everything else, so a slow card only delays the file.
+ */
+static void writer_task_fn(void *arg)
+{
+    (void)arg;
+    TickType_t last_sync = xTaskGetTickCount();
+    int stats_syncs = 0;
+    int index_syncs = 0;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SD_LOG_DRAIN_MS));
+        bool stop = atomic_load(&s_stop);
+
+        xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+        if (s_log_file) {                       /* Otherwise suspended: lines wait in the ring */
+            ring_drain();
+            if (stop || xTaskGetTickCount() - last_sync >= s_sync_ticks) {
+                last_sync = xTaskGetTickCount();
+                write_sensor_samples();
+                write_control_state();
+#if IMU_FIFO_ENABLE
+                write_vibe_summaries();
+#endif
+                if (++stats_syncs >= SD_LOG_I2C_EVERY) {
+                    stats_syncs = 0;
+                    write_i2c_stats();
+                    write_ring_stats();
+                }
+                if (++index_syncs >= SD_LOG_INDEX_EVERY) {
+                    index_syncs = 0;
+                    index_touch();
+                }
+                if (s_dirty) {
+                    sd_flush_sync();
+                }
+            }
+        }
+        xSemaphoreGive(s_log_mutex);
+
+        if (stop) {
+            break;
+        }
+    }
+    s_writer_task = NULL;
+    vTaskDelete(NULL);
+}
 
 /* --------------- log sink -------------------- */
 
+#if SD_LOG_DEFERRED
+static bool in_flash_rodata(const void *p)
+{
+    return esp_ptr_in_drom(p);
+}
+
+/** true for an ESP_LOGW / ESP_LOGE format: "W (" or "E (", after the colour code if any */
+static bool is_warning_or_error(const char *fmt)
+{
+    if (fmt[0] == '\033') {
+        fmt = strchr(fmt, 'm');
+        if (!fmt) {
+            return false;
+        }
+        fmt++;
+    }
+    return (fmt[0] == 'W' || fmt[0] == 'E') && fmt[1] == ' ' && fmt[2] == '(';
+}
+#endif
+
+/** s_orig_vprintf with its own argument list, to echo an already formatted line */
+static int uart_echo(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int ret = s_orig_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
 /**
- * Custom vprintf-like function that writes to both the original UART output
- * and the SD card log file.  This captures all ESP_LOGx() output.
+ * Custom vprintf-like function that feeds the SD card log ring and the
+ * original UART output. This captures all ESP_LOGx() output; the caller
+ * only pays for encoding (or formatting) and a memcpy, never for the card.
+ * With SD_LOG_DEFERRED a call whose format string is in flash (every
+ * ESP_LOGx literal) is stored unformatted for tools/log_decode; only
+ * warnings and errors (or everything, with SD_LOG_UART_ECHO) are also
+ * formatted for the console. Anything else is formatted once
+ * into the same buffer, queued as a text line and echoed from it.
  */
 static int sd_log_vprintf(const char *fmt, va_list args)
 {
-    /* Always write to UART first (so we never lose output) */
+    uint8_t buf[SD_LOG_LINE_MAX];       /* deferred entry or text line, never both */
     va_list args_copy;
-    va_copy(args_copy, args);
-    int ret = s_orig_vprintf(fmt, args_copy);
-    va_end(args_copy);
 
-    /* Format into a buffer and write to SD file */
-    if (s_log_file && s_log_mutex) {
-        if (xSemaphoreTake(s_log_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-            char buf[512];
-            va_copy(args_copy, args);
-            int n = vsnprintf(buf, sizeof(buf), fmt, args_copy);
-            va_end(args_copy);
-            if (n > 0) {
-                size_t len = (size_t)(n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1);
-                fwrite(buf, 1, len, s_log_file);
-                s_dirty = true;
+#if SD_LOG_DEFERRED
+    if (s_ring && s_dlog_file) {
+        va_copy(args_copy, args);
+        size_t n = Log_Defer_Encode(buf, sizeof(buf), esp_timer_get_time(), in_flash_rodata, fmt, args_copy);
+        va_end(args_copy);
+        if (n > 0) {
+            ring_push(buf, (uint32_t)n, REC_DEFERRED);
+            if (SD_LOG_UART_ECHO || is_warning_or_error(fmt)) {
+                va_copy(args_copy, args);
+                s_orig_vprintf(fmt, args_copy);
+                va_end(args_copy);
             }
-            xSemaphoreGive(s_log_mutex);
+            return (int)n;
         }
     }
+#endif
 
-    return ret;
+    va_copy(args_copy, args);
+    int n = vsnprintf((char *)buf, sizeof(buf), fmt, args_copy);
+    va_end(args_copy);
+    if (n <= 0) {
+        return n;
+    }
+    if (s_ring) {
+        ring_push(buf, (uint32_t)(n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1), 0);
+    }
+    if (n < (int)sizeof(buf)) {
+        return uart_echo("%s", (const char *)buf);
+    }
+    /* Truncated for the card; the console still gets the whole line */
+    va_copy(args_copy, args);
+    n = s_orig_vprintf(fmt, args_copy);
+    va_end(args_copy);
+    return n;
+}
+
+/**
+ * Create the session's telemetry file and write its header with the
+ * calibration constants a decoder needs. Logging continues without it
+ * if this fails.
+ */
+static void open_telemetry(int seq, int64_t epoch_us, int64_t timestamp_us)
+{
+    snprintf(s_tlm_path, sizeof(s_tlm_path), "%s/%s%05d%s", SD_LOG_DIR, SD_TLM_PREFIX, seq, SD_TLM_EXT);
+    s_tlm_file = Log_File_Open(s_tlm_path, "w", SD_LOG_PREALLOC_BIN);
+    if (!s_tlm_file) {
+        ESP_LOGW(TAG, "Failed to open telemetry file: %s (errno %d)", s_tlm_path, errno);
+        return;
+    }
+
+    const tlm_calib_t calib = {
+        .therm_model = THERMISTOR_MODEL,
+        .control_channel = THERMISTOR_CONTROL_CHANNEL,
+        .publish_hz = THERMISTOR_PUBLISH_HZ,
+        .nominal_r = THERMISTOR_NOMINAL_R,
+        .nominal_t = THERMISTOR_NOMINAL_T,
+        .beta = THERMISTOR_BETA,
+        .series_r = THERMISTOR_SERIES_R,
+        .sh_a = THERMISTOR_SH_A,
+        .sh_b = THERMISTOR_SH_B,
+        .sh_c = THERMISTOR_SH_C,
+        .supply_scale = (float)(BAT_DIVIDER / Measurement_offset),
+        .brownout_mv = BAT_BROWNOUT_MV,
+        .recover_mv = BAT_RECOVER_MV,
+    };
+    tlm_file_header_t h;
+    Telemetry_Header(&h, (uint32_t)seq, epoch_us, timestamp_us, &calib);
+    fwrite(&h, sizeof(h), 1, s_tlm_file);
+    s_tlm_seq = 0;
+    ESP_LOGI(TAG, "Telemetry file: %s (%u-byte records, schema %d)", s_tlm_path,
+             (unsigned)TLM_RECORD_BYTES, TLM_SCHEMA_VERSION);
 }
 
+#if SD_LOG_DEFERRED
+/**
+ * Create the session's deferred log file. Its header names the ELF the
+ * format addresses belong to; without the file, logging stays text.
+ */
+static void open_deferred(int seq, int64_t epoch_us, int64_t timestamp_us)
+{
+    snprintf(s_dlog_path, sizeof(s_dlog_path), "%s/%s%05d%s", SD_LOG_DIR, SD_DLOG_PREFIX, seq, SD_DLOG_EXT);
+    FILE *f = Log_File_Open(s_dlog_path, "w", SD_LOG_PREALLOC_BIN);
+    if (!f) {
+        ESP_LOGW(TAG, "Failed to open deferred log: %s (errno %d), logging as text", s_dlog_path, errno);
+        return;
+    }
+    log_defer_header_t h = {
+        .magic = LOG_DEFER_MAGIC,
+        .version = LOG_DEFER_VERSION,
+        .header_bytes = sizeof(h),
+        .epoch_us = epoch_us,
+        .timestamp_us = timestamp_us,
+    };
+    char sha[sizeof(h.elf_sha256) + 1];
+    esp_app_get_elf_sha256(sha, sizeof(sha));
+    memcpy(h.elf_sha256, sha, sizeof(h.elf_sha256));
+    fwrite(&h, sizeof(h), 1, f);
+    s_dlog_file = f;                    /* Sink starts deferring from here */
+    ESP_LOGI(TAG, "Deferred log: %s (ELF %.16s)", s_dlog_path, sha);
+}
+#endif
+
 /* --------------- public API ------------------ */
 
 esp_err_t SD_Logger_Init(uint32_t sync_interval_ms)
@@ -184,18 +854,23 @@ esp_err_t SD_Logger_Init(uint32_t sync_interval_ms)
         return ESP_FAIL;
     }
     ESP_LOGI(TAG, "Log directory OK");
+#if LOG_FILE_BENCH
+    Log_File_Bench(SD_LOG_DIR);
+#endif
 
-    /* Rotate old logs */
+    /* Rotate old logs, then claim the next number before any file exists */
     rotate_logs();
+    int seq = (int)s_index.next_seq;
+    s_session = Log_Index_Push(&s_index, (uint32_t)seq, epoch_now());
+    index_save();
 
     /* Determine new filename */
-    int seq = next_sequence();
-    char path[300];
-    snprintf(path, sizeof(path), "%s/%s%05d%s", SD_LOG_DIR, SD_LOG_PREFIX, seq, SD_LOG_EXT);
+    char *path = s_log_path;
+    snprintf(path, sizeof(s_log_path), "%s/%s%05d%s", SD_LOG_DIR, SD_LOG_PREFIX, seq, SD_LOG_EXT);
 
     /* Open file for writing */
     ESP_LOGI(TAG, "Opening log file: %s", path);
-    s_log_file = fopen(path, "w");
+    s_log_file = Log_File_Open(path, "w", SD_LOG_PREALLOC_TEXT);
     if (!s_log_file) {
         ESP_LOGE(TAG, "Failed to open log file: %s (errno %d)", path, errno);
         return ESP_FAIL;
@@ -203,30 +878,89 @@ esp_err_t SD_Logger_Init(uint32_t sync_interval_ms)
     ESP_LOGI(TAG, "Log file opened successfully");
 
     /* Write a header */
+    int64_t t0_epoch_us = RTC_Get_Epoch_Us();
+    int64_t t0_us = esp_timer_get_time();
     int hdr = fprintf(s_log_file, "=== Log #%d started ===\n", seq);
+#if SD_LOG_TEXT_SAMPLES
+    hdr += fprintf(s_log_file, "# S,timestamp_us,{raw_mv,temp_centi_c,flags} x %d (inlet,outlet,ambient),supply_mv\n",
+                   SENSOR_MAX_CHANNELS);
+#endif
+    /* Maps the esp_timer timestamps below onto the RTC-synced wall clock */
+    hdr += fprintf(s_log_file, "# T0,epoch_us=%lld,timestamp_us=%lld\n", (long long)t0_epoch_us, (long long)t0_us);
+    hdr += fprintf(s_log_file, "# Sensor samples, spray edges, control state and health events: %s%05d%s "
+                   "(tools/tlm_decode)\n", SD_TLM_PREFIX, seq, SD_TLM_EXT);
+    hdr += fprintf(s_log_file, "# I,timestamp_us,addr,txns,transfers,bytes_tx,bytes_rx,errors,retries,busy_us,max_us,"
+                   "hist x %d (<%dus doubling)\n", I2C_LAT_BUCKETS, I2C_LAT_BASE_US);
+    hdr += fprintf(s_log_file, "# R,timestamp_us,lines,bytes,dropped_lines,dropped_bytes,high_water,ring_bytes\n");
+#if IMU_FIFO_ENABLE
+    {
+        static const uint16_t bins[IMU_VIBE_BINS] = IMU_VIBE_BIN_HZ;
+        hdr += fprintf(s_log_file, "# V,timestamp_us,frames,rms_x_mg,rms_y_mg,rms_z_mg,peak_mg,"
+                       "gyro_rms_x_mdps,gyro_rms_y_mdps,gyro_rms_z_mdps,band_mg @");
+        for (int b = 0; b < IMU_VIBE_BINS; b++) {
+            hdr += fprintf(s_log_file, " %uHz", (unsigned)bins[b]);
+        }
+        hdr += fprintf(s_log_file, "\n");
+    }
+#endif
+    open_telemetry(seq, t0_epoch_us, t0_us);
+#if SD_LOG_DEFERRED
+    open_deferred(seq, t0_epoch_us, t0_us);
+    if (s_dlog_file) {
+        hdr += fprintf(s_log_file, "# ESP_LOG output: %s%05d%s (tools/log_decode with this build's ELF)\n",
+                       SD_DLOG_PREFIX, seq, SD_DLOG_EXT);
+    }
+#endif
     sd_flush_sync();
     ESP_LOGI(TAG, "Header written (%d bytes), flushed+synced", hdr);
 
+    /* Line ring: PSRAM if there is any, a smaller internal one otherwise */
+    if (!s_ring) {
+        s_ring_mask = SD_LOG_RING_BYTES - 1u;
+        s_ring = heap_caps_calloc(1, SD_LOG_RING_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_ring) {
+            s_ring_mask = SD_LOG_RING_FALLBACK - 1u;
+            s_ring = heap_caps_calloc(1, SD_LOG_RING_FALLBACK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        }
+    }
+    uint32_t ring_bytes = s_ring_mask + 1u;
+
     /* Create mutex */
     s_log_mutex = xSemaphoreCreateMutex();
-    if (!s_log_mutex) {
+    if (!s_log_mutex || !s_ring) {
         fclose(s_log_file);
         s_log_file = NULL;
-        ESP_LOGE(TAG, "Failed to create log mutex");
+        bin_close(&s_tlm_file);
+        bin_close(&s_dlog_file);
+        free(s_ring);
+        s_ring = NULL;
+        if (s_log_mutex) {
+            vSemaphoreDelete(s_log_mutex);
+            s_log_mutex = NULL;
+        }
+        ESP_LOGE(TAG, "Failed to create log mutex / ring");
         return ESP_FAIL;
     }
 
-    /* Redirect ESP log output through our vprintf wrapper */
-    s_orig_vprintf = esp_log_set_vprintf(sd_log_vprintf);
+    /* Log sensor samples published from now on */
+    Sensor_Ring_ReaderInit(&s_sensor_reader);
 
-    /* Start periodic sync timer */
-    s_sync_timer = xTimerCreate("sd_sync", pdMS_TO_TICKS(sync_interval_ms),
-                                pdTRUE, NULL, sync_timer_cb);
-    if (s_sync_timer) {
-        xTimerStart(s_sync_timer, 0);
+    /* Start the writer before anything can fill the ring */
+    s_sync_ticks = pdMS_TO_TICKS(sync_interval_ms);
+    atomic_store(&s_stop, false);
+    if (xTaskCreatePinnedToCore(writer_task_fn, "sd_log", SD_LOG_TASK_STACK, NULL, SD_LOG_TASK_PRIORITY,
+                                &s_writer_task, 0) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start log writer task");
+        s_writer_task = NULL;
+        return ESP_FAIL;                        /* Ring stays allocated but is never fed */
     }
 
-    ESP_LOGI(TAG, "SD card logging started: %s (sync every %lu ms)", path, (unsigned long)sync_interval_ms);
+    /* Redirect ESP log output through our vprintf wrapper */
+    s_orig_vprintf = esp_log_set_vprintf(sd_log_vprintf);
+
+    ESP_LOGI(TAG, "SD card logging started: %s (sync every %lu ms, %lu KB ring in %s)", path,
+             (unsigned long)sync_interval_ms, (unsigned long)(ring_bytes / 1024),
+             ring_bytes == SD_LOG_RING_BYTES ? "PSRAM" : "internal RAM");
     return ESP_OK;
 }
 
@@ -234,36 +968,115 @@ void SD_Logger_Flush(void)
 {
     if (s_log_file && s_log_mutex) {
         if (xSemaphoreTake(s_log_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+            if (s_log_file) {
+                ring_drain();
+            }
             sd_flush_sync();
             xSemaphoreGive(s_log_mutex);
         }
     }
 }
 
-void SD_Logger_Deinit(void)
+esp_err_t SD_Logger_Suspend(void)
 {
-    /* Stop sync timer */
-    if (s_sync_timer) {
-        xTimerStop(s_sync_timer, portMAX_DELAY);
-        xTimerDelete(s_sync_timer, portMAX_DELAY);
-        s_sync_timer = NULL;
+    if (!s_log_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+    if (!s_log_file) {
+        xSemaphoreGive(s_log_mutex);
+        return ESP_OK;
     }
+    ring_drain();                       /* Usually under one drain period of backlog, incl. the brown-out record */
+    fputs("=== Log suspended (supply brown-out) ===\n", s_log_file);
+    sd_flush_sync();
+    /* No trim: the files keep their preallocated, zero-padded size, which
+     * is as consistent on the card as a trimmed one and needs no FAT update */
+    int ret = suspend_close(&s_log_file, &s_log_end);
+    if (suspend_close(&s_tlm_file, &s_tlm_end) != 0 || suspend_close(&s_dlog_file, &s_dlog_end) != 0) {
+        ret = -1;
+    }
+    xSemaphoreGive(s_log_mutex);
+    return ret == 0 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t SD_Logger_Resume(void)
+{
+    if (!s_log_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+    if (!s_log_file) {
+        s_log_file = Log_File_Reopen(s_log_path, s_log_end);
+        if (s_log_file && s_tlm_path[0]) {
+            s_tlm_file = Log_File_Reopen(s_tlm_path, s_tlm_end);
+        }
+        if (s_log_file && s_dlog_path[0]) {
+            s_dlog_file = Log_File_Reopen(s_dlog_path, s_dlog_end);
+        }
+        if (s_log_file) {
+            fprintf(s_log_file, "=== Log resumed at timestamp_us=%lld ===\n", (long long)esp_timer_get_time());
+            sd_flush_sync();
+        }
+    }
+    esp_err_t ret = s_log_file ? ESP_OK : ESP_FAIL;
+    xSemaphoreGive(s_log_mutex);
+    return ret;
+}
+
+void SD_Logger_Record(const tlm_record_t *rec)
+{
+    if (s_ring) {
+        ring_push(rec, sizeof(*rec), REC_BINARY);
+    }
+}
+
+void SD_Logger_Get_Stats(sd_log_stats_t *out)
+{
+    out->ring_bytes    = s_ring ? s_ring_mask + 1u : 0;
+    out->high_water    = atomic_load_explicit(&s_ring_hwm, memory_order_relaxed);
+    out->lines         = s_lines;
+    out->bytes         = s_bytes;
+    out->dropped_lines = atomic_load_explicit(&s_drop_lines, memory_order_relaxed);
+    out->dropped_bytes = atomic_load_explicit(&s_drop_bytes, memory_order_relaxed);
+}
+
+void SD_Logger_Deinit(void)
+{
     if (s_orig_vprintf) {
         esp_log_set_vprintf(s_orig_vprintf);
         s_orig_vprintf = NULL;
     }
+    /* The writer drains the ring and syncs once more on its way out */
+    if (s_writer_task) {
+        atomic_store(&s_stop, true);
+        xTaskNotifyGive(s_writer_task);
+        while (s_writer_task) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
     if (s_log_file) {
         if (s_log_mutex) {
             xSemaphoreTake(s_log_mutex, portMAX_DELAY);
         }
-        fflush(s_log_file);
-        fsync(fileno(s_log_file));
+        sd_flush_sync();
         fclose(s_log_file);
         s_log_file = NULL;
+        bin_close(&s_tlm_file);
+        bin_close(&s_dlog_file);
+        if (s_session) {
+            s_session->bytes = session_bytes(s_session->seq);
+            index_touch();
+            s_session = NULL;
+        }
         if (s_log_mutex) {
             xSemaphoreGive(s_log_mutex);
-            vSemaphoreDelete(s_log_mutex);
-            s_log_mutex = NULL;
         }
     }
+    if (s_log_mutex) {
+        vSemaphoreDelete(s_log_mutex);
+        s_log_mutex = NULL;
+    }
+    /* The ring stays allocated: a caller that entered sd_log_vprintf before
+     * the sink was restored may still be copying into it. A later Init reuses it */
 }
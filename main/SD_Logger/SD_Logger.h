@@ -2,6 +2,7 @@
 
 #include "esp_err.h"
 #include <stdint.h>
+#include "Telemetry.h"
 
 /** Default sync interval in milliseconds */
 #define SD_LOGGER_DEFAULT_SYNC_MS  1000
@@ -9,9 +10,22 @@
 /**
  * @brief Initialize SD card logging.
  *
- * Creates /sdcard/system/logs/ if needed, rotates old logs (keeps last 5),
- * opens a new log file, and redirects ESP_LOGx output to both
- * the UART console and the SD card file.
+ * Creates /sdcard/system/logs/ if needed, rotates old logs (keeps the last
+ * 5 sessions, by the INDEX.BIN session index, see Log_Index.h), opens a
+ * new log file, and redirects ESP_LOGx output to both
+ * the UART console and the SD card file. Sensor ring samples are
+ * written to a binary telemetry file (T%05d.bin, see Telemetry.h) at
+ * every sync, with a control state snapshot.
+ *
+ * Only the low-priority "sd_log" writer task touches the card. ESP_LOGx
+ * callers format their line and copy it into a lock-free ring (64 KB in
+ * PSRAM), so they never wait for the card or for each other; when the
+ * ring is full the line is dropped and counted (SD_Logger_Get_Stats()).
+ * ESP_LOGx calls are stored unformatted in D%05d.bin (Log_Defer.h, decode
+ * with tools/log_decode and the build's ELF); L%05d.txt keeps the logger's
+ * own lines and any call whose format string is not in flash. Deferred
+ * calls are not printed on the UART while the card is logging (nothing on
+ * the calling task formats them); set SD_LOG_UART_ECHO to get them back.
  *
  * Must be called AFTER SD_Init().
  *
@@ -29,6 +43,49 @@ esp_err_t SD_Logger_Init(uint32_t sync_interval_ms);
 void SD_Logger_Flush(void);
 
 /**
- * @brief Stop SD card logging and close the file.
+ * @brief Flush, sync and close the log file without tearing the logger down.
+ *
+ * For a supply brown-out: writes out what is already queued (both files),
+ * then once this returns the FAT entries are consistent and nothing
+ * writes to the card. Log lines keep collecting in the ring
+ * (dropped and counted once it is full) until SD_Logger_Resume(). Waits
+ * for a write in progress.
+ */
+esp_err_t SD_Logger_Suspend(void);
+
+/**
+ * @brief Reopen the suspended log files where they stopped, still preallocated.
+ */
+esp_err_t SD_Logger_Resume(void);
+
+/**
+ * @brief Queue a telemetry record (spray edge, health event) for the .bin file.
+ *
+ * Same lock-free path as a log line: never blocks, dropped and counted if
+ * the ring is full, discarded before SD_Logger_Init(). Not from an ISR.
+ * The writer stamps the sequence number and CRC.
+ */
+void SD_Logger_Record(const tlm_record_t *rec);
+
+/** Log ring counters, cumulative since boot */
+typedef struct {
+    uint32_t ring_bytes;        /*!< Ring capacity, 0 before SD_Logger_Init() */
+    uint32_t high_water;        /*!< Most bytes ever queued (headers and padding included) */
+    uint32_t lines;             /*!< Lines taken off the ring by the writer */
+    uint32_t bytes;             /*!< ... and their text bytes */
+    uint32_t dropped_lines;     /*!< Lines and telemetry records lost because the ring was full */
+    uint32_t dropped_bytes;
+} sd_log_stats_t;
+
+/**
+ * @brief Snapshot the log ring counters. Lock-free, callable from any task.
+ *
+ * The same counters are written to the log as an "R,..." line with every
+ * I2C statistics block.
+ */
+void SD_Logger_Get_Stats(sd_log_stats_t *out);
+
+/**
+ * @brief Stop SD card logging, drain the ring and close the file.
  */
 void SD_Logger_Deinit(void);
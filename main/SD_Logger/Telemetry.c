@@ -0,0 +1,118 @@
+#include "Telemetry.h"
+
+#include <math.h>
+#include <string.h>
+
+/***********************
+ *  STATIC VARIABLES
+ ***********************/
+static const uint16_t crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/***********************
+ *  STATIC FUNCTIONS
+ ***********************/
+static void begin(tlm_record_t *r, tlm_type_t type, int64_t timestamp_us)
+{
+    memset(r, 0, sizeof(*r));
+    r->sync = TLM_SYNC;
+    r->type = (uint8_t)type;
+    r->timestamp_us = timestamp_us;
+}
+
+static int16_t clamp16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN + 1 ? INT16_MIN + 1 : (int16_t)v);
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+uint16_t Telemetry_Crc16(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc = (uint16_t)(crc << 4) ^ crc_nibble[(crc >> 12) ^ (*p >> 4)];
+        crc = (uint16_t)(crc << 4) ^ crc_nibble[(crc >> 12) ^ (*p & 0x0F)];
+        p++;
+    }
+    return crc;
+}
+
+void Telemetry_Header(tlm_file_header_t *h, uint32_t log_seq, int64_t epoch_us, int64_t timestamp_us,
+                      const tlm_calib_t *calib)
+{
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, TLM_MAGIC, sizeof(h->magic));
+    h->schema = TLM_SCHEMA_VERSION;
+    h->header_bytes = sizeof(*h);
+    h->record_bytes = TLM_RECORD_BYTES;
+    h->channels = SENSOR_MAX_CHANNELS;
+    h->log_seq = log_seq;
+    h->epoch_us = epoch_us;
+    h->timestamp_us = timestamp_us;
+    h->calib = *calib;
+    h->crc = Telemetry_Crc16(h, offsetof(tlm_file_header_t, crc));
+}
+
+void Telemetry_Sensor(tlm_record_t *r, const sensor_sample_t *s)
+{
+    begin(r, TLM_TYPE_SENSOR, s->timestamp_us);
+    for (int ch = 0; ch < SENSOR_MAX_CHANNELS; ch++) {
+        r->p.sensor.raw_mv[ch] = clamp16(s->raw_mv[ch]);
+        r->p.sensor.temp_centi_c[ch] = isnan(s->temp_c[ch]) ? TLM_TEMP_INVALID
+                                     : clamp16((int32_t)lroundf(s->temp_c[ch] * 100.0f));
+        r->p.sensor.flags[ch] = (uint8_t)s->flags[ch];
+    }
+    r->p.sensor.supply_mv = clamp16(s->supply_mv);
+}
+
+void Telemetry_Spray(tlm_record_t *r, int64_t timestamp_us, tlm_spray_edge_t edge, uint8_t mode,
+                     uint32_t duration_ms, int32_t timing_us, uint32_t lead_ms)
+{
+    begin(r, TLM_TYPE_SPRAY, timestamp_us);
+    r->p.spray.edge = (uint8_t)edge;
+    r->p.spray.mode = mode;
+    r->p.spray.predictive = lead_ms > 0;
+    r->p.spray.duration_ms = duration_ms;
+    r->p.spray.timing_us = timing_us;
+    r->p.spray.lead_ms = lead_ms;
+}
+
+void Telemetry_Control(tlm_record_t *r, int64_t timestamp_us, const tlm_control_t *c)
+{
+    begin(r, TLM_TYPE_CONTROL, timestamp_us);
+    r->p.control = *c;
+}
+
+void Telemetry_Health(tlm_record_t *r, int64_t timestamp_us, tlm_health_event_t event, uint8_t channel,
+                      int32_t value, uint32_t detail)
+{
+    begin(r, TLM_TYPE_HEALTH, timestamp_us);
+    r->p.health.event = (uint8_t)event;
+    r->p.health.channel = channel;
+    r->p.health.value = value;
+    r->p.health.detail = detail;
+}
+
+void Telemetry_Seal(tlm_record_t *r, uint16_t seq)
+{
+    r->seq = seq;
+    r->crc = Telemetry_Crc16(r, offsetof(tlm_record_t, crc));
+}
+
+bool Telemetry_Check(const tlm_record_t *r)
+{
+    return r->sync == TLM_SYNC && r->type >= TLM_TYPE_SENSOR && r->type <= TLM_TYPE_HEALTH &&
+           r->crc == Telemetry_Crc16(r, offsetof(tlm_record_t, crc));
+}
+
+bool Telemetry_Check_Header(const tlm_file_header_t *h)
+{
+    return memcmp(h->magic, TLM_MAGIC, sizeof(h->magic)) == 0 && h->schema == TLM_SCHEMA_VERSION &&
+           h->header_bytes == sizeof(*h) && h->record_bytes == TLM_RECORD_BYTES &&
+           h->crc == Telemetry_Crc16(h, offsetof(tlm_file_header_t, crc));
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Sensor_Ring.h"
+
+/***********************
+ *  BINARY TELEMETRY FORMAT
+ *  One file per log session (T%05d.bin next to L%05d.txt): a fixed
+ *  tlm_file_header_t, then fixed TLM_RECORD_BYTES records. Every record
+ *  starts with TLM_SYNC and ends with a CRC-16/CCITT-FALSE over the rest,
+ *  so a reader can resynchronise after a torn write by scanning for the
+ *  next sync byte with a good CRC. seq counts records per file; a gap
+ *  means records were lost on the card, not in the ring (ring drops are
+ *  reported as TLM_HEALTH_LOG_DROP). Everything is little-endian and
+ *  packed. Plain C with no ESP-IDF dependencies, so tools/tlm_decode
+ *  builds against this header.
+ *
+ *  Bump TLM_SCHEMA_VERSION whenever a layout or a unit changes.
+ ***********************/
+#define TLM_MAGIC               "ICTL"
+#define TLM_SCHEMA_VERSION      1
+#define TLM_SYNC                0xA5
+#define TLM_RECORD_BYTES        32
+#define TLM_PAYLOAD_BYTES       18
+#define TLM_TEMP_INVALID        INT16_MIN   // temp_centi_c of a NAN / out of range reading
+
+/** Record types */
+typedef enum {
+    TLM_TYPE_SENSOR  = 1,       // One sensor ring sample, every sample
+    TLM_TYPE_SPRAY   = 2,       // Relay edge
+    TLM_TYPE_CONTROL = 3,       // Control state snapshot, once per log sync
+    TLM_TYPE_HEALTH  = 4,       // Supply / probe / logger event
+} tlm_type_t;
+
+/** tlm_spray_t.edge */
+typedef enum {
+    TLM_SPRAY_ON    = 1,        // timing_us: sample -> relay ON latency
+    TLM_SPRAY_OFF   = 2,        // timing_us: actual - scheduled OFF edge
+    TLM_SPRAY_ABORT = 3,        // Cycle cut short (disable, tank empty, fault, mode change)
+} tlm_spray_edge_t;
+
+/** tlm_health_t.event */
+typedef enum {
+    TLM_HEALTH_BROWNOUT     = 1,    // value: supply mV
+    TLM_HEALTH_SUPPLY_OK    = 2,    // value: supply mV
+    TLM_HEALTH_PROBE_FAULT  = 3,    // channel, detail: sample flags
+    TLM_HEALTH_PROBE_OK     = 4,    // channel, detail: sample flags
+    TLM_HEALTH_LOG_DROP     = 5,    // value: log lines / records lost in the ring since the last one
+} tlm_health_event_t;
+
+/** tlm_control_t.flags */
+#define TLM_CTRL_ENABLED        (1u << 0)
+#define TLM_CTRL_TANK_EMPTY     (1u << 1)
+#define TLM_CTRL_SENSOR_FAULT   (1u << 2)
+#define TLM_CTRL_BROWNOUT       (1u << 3)
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct __attribute__((packed)) {
+    int16_t  raw_mv[SENSOR_MAX_CHANNELS];
+    int16_t  temp_centi_c[SENSOR_MAX_CHANNELS];     // TLM_TEMP_INVALID if NAN
+    uint8_t  flags[SENSOR_MAX_CHANNELS];            // SENSOR_FLAG_* (all fit in 8 bits)
+    int16_t  supply_mv;
+    uint8_t  reserved;
+} tlm_sensor_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  edge;              // tlm_spray_edge_t
+    uint8_t  mode;              // spray_mode_t
+    uint8_t  predictive;        // ON edge started on the forecast
+    uint8_t  reserved;
+    uint32_t duration_ms;       // Scheduled ON time (ON edge)
+    int32_t  timing_us;         // See tlm_spray_edge_t
+    uint32_t lead_ms;           // Forecast lead time (predictive ON edge)
+    uint16_t reserved2;
+} tlm_spray_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  mode;              // spray_mode_t
+    uint8_t  state;             // spray_state_t
+    uint8_t  flags;             // TLM_CTRL_*
+    uint8_t  reserved;
+    int16_t  trigger_centi_c;
+    uint16_t duty_permille;     // DUTY mode controller output
+    uint16_t duration_ms;       // g_sprayer_duration
+    uint16_t interval_s;        // g_sprayer_interval
+    uint32_t cycles;            // Spray cycles since boot
+    uint16_t reserved2;
+} tlm_control_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  event;             // tlm_health_event_t
+    uint8_t  channel;           // Probe channel, 0xFF if none
+    uint16_t reserved;
+    int32_t  value;
+    uint32_t detail;
+    uint8_t  reserved2[6];
+} tlm_health_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  sync;              // TLM_SYNC
+    uint8_t  type;              // tlm_type_t
+    uint16_t seq;               // Per-file record counter, set by Telemetry_Seal()
+    int64_t  timestamp_us;      // esp_timer time base (see tlm_file_header_t for wall clock)
+    union {
+        tlm_sensor_t  sensor;
+        tlm_spray_t   spray;
+        tlm_control_t control;
+        tlm_health_t  health;
+        uint8_t       raw[TLM_PAYLOAD_BYTES];
+    } p;
+    uint16_t crc;               // CRC-16/CCITT-FALSE of every byte before it
+} tlm_record_t;
+
+/** Calibration constants a decoder needs to turn raw_mv back into °C / volts */
+typedef struct __attribute__((packed)) {
+    uint8_t  therm_model;       // therm_model_t
+    uint8_t  control_channel;   // THERMISTOR_CONTROL_CHANNEL
+    uint16_t publish_hz;        // Sensor records per second
+    float    nominal_r;         // THERMISTOR_NOMINAL_R
+    float    nominal_t;         // THERMISTOR_NOMINAL_T
+    float    beta;
+    float    series_r;
+    float    sh_a;
+    float    sh_b;
+    float    sh_c;
+    float    supply_scale;      // Supply mV per pin mV (divider / offset)
+    int16_t  brownout_mv;
+    int16_t  recover_mv;
+} tlm_calib_t;
+
+typedef struct __attribute__((packed)) {
+    char     magic[4];          // TLM_MAGIC
+    uint16_t schema;            // TLM_SCHEMA_VERSION
+    uint16_t header_bytes;      // sizeof(tlm_file_header_t)
+    uint16_t record_bytes;      // TLM_RECORD_BYTES
+    uint8_t  channels;          // SENSOR_MAX_CHANNELS
+    uint8_t  reserved;
+    uint32_t log_seq;           // Number of the matching L%05d.txt
+    int64_t  epoch_us;          // Wall clock (RTC) at timestamp_us, 0 if unknown
+    int64_t  timestamp_us;
+    tlm_calib_t calib;
+    uint16_t crc;               // CRC-16/CCITT-FALSE of every byte before it
+} tlm_file_header_t;
+
+_Static_assert(sizeof(tlm_record_t) == TLM_RECORD_BYTES, "tlm_record_t must be TLM_RECORD_BYTES");
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ *  The record builders fill type, timestamp and payload only; the writer
+ *  stamps seq and the CRC with Telemetry_Seal() as it writes, so a
+ *  producer's cost is a few stores.
+ ***********************/
+
+/** CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), nibble table */
+uint16_t Telemetry_Crc16(const void *data, size_t len);
+
+void Telemetry_Header(tlm_file_header_t *h, uint32_t log_seq, int64_t epoch_us, int64_t timestamp_us,
+                      const tlm_calib_t *calib);
+
+void Telemetry_Sensor(tlm_record_t *r, const sensor_sample_t *s);
+
+void Telemetry_Spray(tlm_record_t *r, int64_t timestamp_us, tlm_spray_edge_t edge, uint8_t mode,
+                     uint32_t duration_ms, int32_t timing_us, uint32_t lead_ms);
+
+void Telemetry_Control(tlm_record_t *r, int64_t timestamp_us, const tlm_control_t *c);
+
+void Telemetry_Health(tlm_record_t *r, int64_t timestamp_us, tlm_health_event_t event, uint8_t channel,
+                      int32_t value, uint32_t detail);
+
+/** Set seq and the CRC. Call once, just before the record is written */
+void Telemetry_Seal(tlm_record_t *r, uint16_t seq);
+
+/** @return true if r has the sync byte, a known type and a good CRC */
+bool Telemetry_Check(const tlm_record_t *r);
+
+/** @return true if h has the magic, this schema and a good CRC */
+bool Telemetry_Check_Header(const tlm_file_header_t *h);
@@ -0,0 +1,79 @@
+#include "Sensor_Health.h"
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Sensor_Health_Init(sensor_health_state_t *h)
+{
+    *h = (sensor_health_state_t) { 0 };
+}
+
+uint32_t Sensor_Health_Check(sensor_health_state_t *h, int32_t raw_mv, uint32_t code_q8,
+                             int32_t centi_c, bool in_range, uint32_t publish_hz)
+{
+    uint32_t bad = 0;
+
+    /* Open / short: the divider is at a rail. If the converter rejected a
+     * reading between the thresholds, blame the nearer rail. */
+    if (raw_mv >= SENSOR_OPEN_MV) {
+        bad |= SENSOR_FLAG_OPEN;
+    } else if (raw_mv <= SENSOR_SHORT_MV) {
+        bad |= SENSOR_FLAG_SHORT;
+    } else if (!in_range) {
+        bad |= (raw_mv >= SENSOR_OPEN_MV / 2) ? SENSOR_FLAG_OPEN : SENSOR_FLAG_SHORT;
+    }
+
+    /* Stuck: an averaged code never repeats exactly for long on a live probe */
+    if (h->have_last && code_q8 == h->last_code_q8) {
+        if (h->same_count < UINT16_MAX) h->same_count++;
+    } else {
+        h->same_count = 0;
+    }
+    if (h->same_count >= SENSOR_STUCK_READINGS) {
+        bad |= SENSOR_FLAG_STUCK;
+    }
+
+    /* Rate of change against the previous in-range reading */
+    if (in_range && !(bad & (SENSOR_FLAG_OPEN | SENSOR_FLAG_SHORT))) {
+        int32_t max_step = (int32_t)(SENSOR_RATE_MAX_C_PER_S * 100.0f) / (int32_t)(publish_hz ? publish_hz : 1);
+        int32_t step = centi_c - h->last_centi_c;
+        if (h->have_last && (step > max_step || step < -max_step)) {
+            bad |= SENSOR_FLAG_RATE;
+        }
+        h->last_centi_c = centi_c;
+    }
+    h->last_code_q8 = code_q8;
+    h->have_last = true;
+
+    /* Latch / clear with hysteresis */
+    if (bad) {
+        h->good_run = 0;
+        if (h->bad_run < UINT8_MAX) h->bad_run++;
+        if (!h->latched && h->bad_run >= SENSOR_FAULT_CONFIRM) {
+            h->latched = true;
+            h->latched_flags = bad;
+        }
+    } else {
+        h->bad_run = 0;
+        if (h->latched && ++h->good_run >= SENSOR_FAULT_CLEAR) {
+            h->latched = false;
+            h->latched_flags = 0;
+            h->good_run = 0;
+        }
+    }
+
+    if (h->latched) {
+        return bad | h->latched_flags | SENSOR_FLAG_FAULT;
+    }
+    return bad ? bad : SENSOR_FLAG_VALID;
+}
+
+const char *Sensor_Health_Reason(uint32_t flags)
+{
+    if (flags & SENSOR_FLAG_OPEN)  return "open circuit";
+    if (flags & SENSOR_FLAG_SHORT) return "short circuit";
+    if (flags & SENSOR_FLAG_STUCK) return "stuck reading";
+    if (flags & SENSOR_FLAG_RATE)  return "rate of change";
+    if (flags & SENSOR_FLAG_VALID) return "ok";
+    return "no data";
+}
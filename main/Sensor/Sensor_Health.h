@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Sensor_Ring.h"
+
+/***********************
+ *  FAULT THRESHOLDS
+ *  Checked once per published reading (10 Hz), O(1) per channel.
+ *  A reading that fails any check is never marked SENSOR_FLAG_VALID.
+ *  SENSOR_FAULT_CONFIRM bad readings in a row latch SENSOR_FLAG_FAULT,
+ *  which then needs SENSOR_FAULT_CLEAR good readings in a row to clear.
+ ***********************/
+#define SENSOR_OPEN_MV              3290    // At or above: open circuit (NTC to GND missing)
+#define SENSOR_SHORT_MV             10      // At or below: short circuit
+#define SENSOR_STUCK_READINGS       100     // Identical averaged codes in a row (10 s)
+#define SENSOR_RATE_MAX_C_PER_S     50.0f   // Faster than any real intake air change (judged after the median)
+#define SENSOR_FAULT_CONFIRM        5       // Bad readings to latch a fault (0.5 s)
+#define SENSOR_FAULT_CLEAR          20      // Good readings to clear it (2 s)
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+
+/** Per-channel health, derived from a sample's flags */
+typedef enum {
+    SENSOR_HEALTH_DISABLED,     // Channel not sampled / nothing published yet
+    SENSOR_HEALTH_OK,           // Reading usable
+    SENSOR_HEALTH_SUSPECT,      // Reading rejected, fault not (yet) confirmed
+    SENSOR_HEALTH_FAULT,        // Fault latched; readings ignored until it clears
+} sensor_health_t;
+
+/** Classifier state, one per channel */
+typedef struct {
+    uint32_t last_code_q8;      // Previous averaged ADC code
+    int32_t  last_centi_c;      // Previous in-range temperature (0.01 °C)
+    bool     have_last;         // last_* hold a reading
+    uint16_t same_count;        // Consecutive identical codes
+    uint8_t  bad_run;           // Consecutive bad readings
+    uint8_t  good_run;          // Consecutive good readings while latched
+    bool     latched;           // SENSOR_FLAG_FAULT is set
+    uint32_t latched_flags;     // Bad flags that latched the fault
+} sensor_health_state_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Clear a channel's classifier state */
+void Sensor_Health_Init(sensor_health_state_t *h);
+
+/**
+ * Classify one reading.
+ * @param raw_mv    Averaged ADC voltage
+ * @param code_q8   Averaged ADC code (any fixed-point scale, compared for equality)
+ * @param centi_c   Median-filtered temperature in 0.01 °C, ignored when !in_range.
+ *                  The rate check runs on it, so a lone ignition spike (which
+ *                  the median removes) is not a RATE fault; a jump the median
+ *                  confirms is
+ * @param in_range  false if the converter could not produce a temperature,
+ *                  or Sensor_Health_Plausible() is false
+ * @param publish_hz Readings per second, scales the rate-of-change limit
+ * @return SENSOR_FLAG_VALID, or the SENSOR_FLAG_BAD_MASK bits of this reading,
+ *         plus SENSOR_FLAG_FAULT while a fault is latched
+ */
+uint32_t Sensor_Health_Check(sensor_health_state_t *h, int32_t raw_mv, uint32_t code_q8,
+                             int32_t centi_c, bool in_range, uint32_t publish_hz);
+
+/**
+ * @return true if a reading is off both rails and converted, i.e. worth
+ *         feeding to the filter ahead of Sensor_Health_Check()
+ */
+static inline bool Sensor_Health_Plausible(int32_t raw_mv, bool in_range)
+{
+    return in_range && raw_mv > SENSOR_SHORT_MV && raw_mv < SENSOR_OPEN_MV;
+}
+
+/** Map a sample's per-channel flags to a health state */
+static inline sensor_health_t Sensor_Health_FromFlags(uint32_t flags)
+{
+    if (flags & SENSOR_FLAG_FAULT) return SENSOR_HEALTH_FAULT;
+    if (flags & SENSOR_FLAG_VALID) return SENSOR_HEALTH_OK;
+    if (flags & SENSOR_FLAG_BAD_MASK) return SENSOR_HEALTH_SUSPECT;
+    return SENSOR_HEALTH_DISABLED;
+}
+
+/** @return Short description of the most significant problem in flags ("open circuit", "ok", ...) */
+const char *Sensor_Health_Reason(uint32_t flags);
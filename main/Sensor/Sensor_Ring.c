@@ -0,0 +1,101 @@
+#include "Sensor_Ring.h"
+
+#include <stdatomic.h>
+
+#define RING_MASK   (SENSOR_RING_SIZE - 1)
+
+_Static_assert((SENSOR_RING_SIZE & RING_MASK) == 0, "SENSOR_RING_SIZE must be a power of two");
+
+/***********************
+ *  INTERNAL STATE
+ *  Each slot carries a sequence stamp (seqlock). The producer sets it odd
+ *  while writing and to 2 * (n + 1) once sample n is complete. A reader
+ *  copies the slot and accepts it only if the stamp was the expected even
+ *  value both before and after the copy.
+ ***********************/
+typedef struct {
+    atomic_uint     stamp;
+    sensor_sample_t sample;
+} ring_slot_t;
+
+static ring_slot_t slots[SENSOR_RING_SIZE];
+static atomic_uint head = 0;     // Number of samples published so far
+
+/***********************
+ *  HELPERS
+ ***********************/
+
+/** Try to copy sample number seq. Fails if it is not (or no longer) in the ring. */
+static bool read_slot(uint32_t seq, sensor_sample_t *out)
+{
+    ring_slot_t *slot = &slots[seq & RING_MASK];
+    uint32_t expected = 2u * (seq + 1u);
+
+    uint32_t before = atomic_load_explicit(&slot->stamp, memory_order_acquire);
+    if (before != expected) return false;
+
+    *out = slot->sample;
+
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t after = atomic_load_explicit(&slot->stamp, memory_order_relaxed);
+    return after == expected;
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Sensor_Ring_Push(const sensor_sample_t *sample)
+{
+    uint32_t seq = atomic_load_explicit(&head, memory_order_relaxed);
+    ring_slot_t *slot = &slots[seq & RING_MASK];
+
+    atomic_store_explicit(&slot->stamp, 2u * seq + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->sample = *sample;
+    atomic_store_explicit(&slot->stamp, 2u * (seq + 1u), memory_order_release);
+
+    atomic_store_explicit(&head, seq + 1u, memory_order_release);
+}
+
+bool Sensor_Ring_Latest(sensor_sample_t *out)
+{
+    /* The producer can lap us between reading head and the slot; retry
+     * with the new head, which is bounded by the publish rate. */
+    for (;;) {
+        uint32_t h = atomic_load_explicit(&head, memory_order_acquire);
+        if (h == 0) return false;
+        if (read_slot(h - 1u, out)) return true;
+    }
+}
+
+void Sensor_Ring_ReaderInit(sensor_reader_t *reader)
+{
+    reader->next = atomic_load_explicit(&head, memory_order_acquire);
+    reader->dropped = 0;
+}
+
+size_t Sensor_Ring_Read(sensor_reader_t *reader, sensor_sample_t *out, size_t max)
+{
+    size_t n = 0;
+
+    while (n < max) {
+        uint32_t h = atomic_load_explicit(&head, memory_order_acquire);
+        if (reader->next == h) break;
+
+        /* Lapped: skip what has been overwritten */
+        if (h - reader->next > SENSOR_RING_SIZE) {
+            reader->dropped += (h - reader->next) - SENSOR_RING_SIZE;
+            reader->next = h - SENSOR_RING_SIZE;
+        }
+
+        if (read_slot(reader->next, &out[n])) {
+            n++;
+            reader->next++;
+        } else if (atomic_load_explicit(&head, memory_order_acquire) - reader->next >= SENSOR_RING_SIZE) {
+            /* Overwritten while we copied it: count it and move on */
+            reader->dropped++;
+            reader->next++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/***********************
+ *  RING CONFIGURATION
+ *  64 samples = 6.4 s of history at the default 10 Hz publish rate.
+ *  Each sample holds every probe from the same scan, so derived values
+ *  (e.g. intercooler delta-T) always compare simultaneous readings.
+ ***********************/
+#define SENSOR_RING_SIZE        64      // Must be a power of two
+#define SENSOR_MAX_CHANNELS     3       // Probes carried per sample (one ADC scan)
+
+/***********************
+ *  SAMPLE FLAGS
+ ***********************/
+#define SENSOR_FLAG_VALID       (1u << 0)   // temp_c is a usable temperature (health OK)
+#define SENSOR_FLAG_OPEN        (1u << 1)   // Voltage at the top rail: probe disconnected
+#define SENSOR_FLAG_SHORT       (1u << 2)   // Voltage at ground: probe or wiring shorted
+#define SENSOR_FLAG_STUCK       (1u << 3)   // ADC code frozen for SENSOR_STUCK_READINGS
+#define SENSOR_FLAG_RATE        (1u << 4)   // Jump faster than SENSOR_RATE_MAX_C_PER_S
+#define SENSOR_FLAG_FAULT       (1u << 5)   // Fault confirmed and latched (see Sensor_Health.h)
+#define SENSOR_FLAG_TREND       (1u << 6)   // rate_c_per_s / forecast_c are valid (fit window full)
+
+#define SENSOR_FLAG_BAD_MASK    (SENSOR_FLAG_OPEN | SENSOR_FLAG_SHORT | SENSOR_FLAG_STUCK | SENSOR_FLAG_RATE)
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+/** One scan of every probe, indexed by channel (see therm_channel_id_t) */
+typedef struct {
+    int64_t  timestamp_us;                      // esp_timer_get_time() when the scan was published
+    int32_t  raw_mv[SENSOR_MAX_CHANNELS];       // Averaged ADC voltage in mV
+    float    temp_c[SENSOR_MAX_CHANNELS];       // Filtered °C with SENSOR_FLAG_VALID, else unfiltered °C or NAN
+    float    rate_c_per_s[SENSOR_MAX_CHANNELS]; // Least-squares dT/dt (with SENSOR_FLAG_TREND)
+    float    forecast_c[SENSOR_MAX_CHANNELS];   // Fitted temperature THERMISTOR_FORECAST_S ahead (with SENSOR_FLAG_TREND)
+    uint32_t flags[SENSOR_MAX_CHANNELS];        // SENSOR_FLAG_*, 0 for a disabled channel
+    int32_t  supply_mv;                         // Filtered supply voltage (BAT_Driver.h), -1 if not monitored
+} sensor_sample_t;
+
+/**
+ * Per-consumer read cursor. Each consumer (control, UI, logger) owns one
+ * and advances it at its own rate; readers never block the producer or
+ * each other.
+ */
+typedef struct {
+    uint32_t next;          // Sequence number of the next sample to read
+    uint32_t dropped;       // Samples overwritten before this reader got to them
+} sensor_reader_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * Publish a sample. Single producer only (the ADC consumer task).
+ * Wait-free: never blocks, overwrites the oldest sample when full.
+ */
+void Sensor_Ring_Push(const sensor_sample_t *sample);
+
+/**
+ * Copy the newest sample. Lock-free, safe from any task.
+ * @return false if nothing has been published yet
+ */
+bool Sensor_Ring_Latest(sensor_sample_t *out);
+
+/**
+ * Position a reader at the newest sample, so the next read returns only
+ * samples published after this call.
+ */
+void Sensor_Ring_ReaderInit(sensor_reader_t *reader);
+
+/**
+ * Copy up to max samples the reader has not seen yet, oldest first.
+ * If the reader fell more than SENSOR_RING_SIZE behind, the overwritten
+ * samples are skipped and counted in reader->dropped.
+ * @return Number of samples copied
+ */
+size_t Sensor_Ring_Read(sensor_reader_t *reader, sensor_sample_t *out, size_t max);
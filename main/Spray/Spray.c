@@ -0,0 +1,623 @@
+#include "Spray.h"
+
+#include "TCA9554PWR.h"
+#include "Thermistor.h"
+#include "Spray_PID.h"
+#include "Driver_Events.h"
+#include "SD_Logger.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Access the global runtime settings */
+#include "screen_trigger_temp.h"    /* g_trigger_temperature    */
+#include "screen_spray_duration.h"  /* g_sprayer_duration       */
+#include "screen_spray_interval.h"  /* g_sprayer_interval       */
+
+static const char *SPRAY_TAG = "Spray";
+
+/***********************
+ *  INTERNAL STATE
+ *  All state transitions happen under s_lock so the driver task (ON edge)
+ *  and the esp_timer task (OFF / hold-off edges) never race. The relay is
+ *  an I2C write through the bus task, which can queue behind other
+ *  traffic and take up to a bus timeout plus a retry when it fails, so
+ *  neither of them writes it: a transition only notifies the "spray_relay"
+ *  task, the one writer. It drives the relay to whatever s_state is by
+ *  then, finishes the edge's timing once the write is done, and retries
+ *  a failed write until the relay matches s_state. No esp_timer callback
+ *  ever blocks on I2C.
+ ***********************/
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_relay_task = NULL;
+static volatile bool s_relay_on = false;    /* Last level the expander acknowledged */
+
+static volatile spray_state_t s_state = SPRAY_STATE_IDLE;
+static bool s_enabled = true;
+static bool s_tank_empty = false;
+static volatile spray_mode_t s_mode = SPRAY_DEFAULT_MODE;
+static volatile bool s_sensor_fault = false;
+
+static esp_timer_handle_t s_off_timer = NULL;
+static esp_timer_handle_t s_holdoff_timer = NULL;
+static esp_timer_handle_t s_pid_timer = NULL;
+
+/* DUTY mode controller, only touched from the esp_timer task */
+static spray_pid_t s_pid;
+static volatile float s_duty = 0.0f;
+
+/* Absolute esp_timer deadlines, used to measure edge error and to
+ * discard callbacks that were already queued when a cycle was aborted. */
+static int64_t s_off_deadline_us = 0;
+static int64_t s_holdoff_deadline_us = 0;
+
+static spray_stats_t s_stats = { .min_latency_us = UINT32_MAX, .last_actual_lead_ms = -1 };
+
+/* Predictive cycle waiting for the probe to actually cross the threshold */
+static bool s_lead_pending = false;
+static int64_t s_lead_fire_us = 0;
+
+/* Edges waiting for the relay task, under s_lock. ON: the cycle starts
+ * (OFF timer, stats) once the relay is really on. OFF: the edge error is
+ * taken once the relay is really off. */
+static bool s_on_pending = false;
+static int64_t s_on_duration_us = 0;
+static int64_t s_on_ref_us = 0;
+static uint32_t s_on_lead_ms = 0;
+static char s_on_reason[96];
+static bool s_off_pending = false;
+
+/* Current cycle comes from the sensor-fault TIMED fallback, so it is
+ * followed by a hold-off even in DUTY mode */
+static bool s_cycle_fallback = false;
+
+/***********************
+ *  HELPERS
+ ***********************/
+static inline esp_err_t relay_set(bool on)
+{
+    return Set_EXIO(SPRAY_RELAY_EXIO, on ? SPRAY_RELAY_ON_LEVEL : !SPRAY_RELAY_ON_LEVEL);
+}
+
+/** Ask the relay task to bring the relay in line with s_state. Never blocks. */
+static inline void relay_kick(void)
+{
+    if (s_relay_task) {
+        xTaskNotifyGive(s_relay_task);
+    }
+}
+
+/**
+ * Cut an active ON phase and force the relay off. A cycle whose relay was
+ * already on still gets its hold-off, and one already in HOLDOFF keeps
+ * the rest of it, so toggling power or a sloshing tank switch cannot
+ * restart the spray early.
+ */
+static void spray_abort(void)
+{
+    int64_t interval_us = (int64_t)g_sprayer_interval * 1000000LL;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_state != SPRAY_STATE_SPRAYING) {
+        portEXIT_CRITICAL(&s_lock);
+        return;     /* IDLE, or HOLDOFF with its timer still running */
+    }
+    bool was_spraying = !s_on_pending;
+    bool holdoff = was_spraying && (s_mode != SPRAY_MODE_DUTY || s_cycle_fallback);
+    s_state = holdoff ? SPRAY_STATE_HOLDOFF : SPRAY_STATE_IDLE;
+    s_holdoff_deadline_us = esp_timer_get_time() + interval_us;
+    s_on_pending = false;               /* Relay never got to switch on: no cycle */
+    portEXIT_CRITICAL(&s_lock);
+
+    esp_timer_stop(s_off_timer);        /* ESP_ERR_INVALID_STATE if not running — fine */
+    if (holdoff) {
+        esp_timer_start_once(s_holdoff_timer, (uint64_t)interval_us);
+    }
+    relay_kick();
+
+    if (was_spraying) {
+        tlm_record_t rec;
+        Telemetry_Spray(&rec, esp_timer_get_time(), TLM_SPRAY_ABORT, (uint8_t)s_mode, 0, 0, 0);
+        SD_Logger_Record(&rec);
+    }
+}
+
+static const char *mode_name(spray_mode_t mode)
+{
+    switch (mode) {
+        case SPRAY_MODE_EFFICIENCY: return "efficiency";
+        case SPRAY_MODE_DUTY:       return "duty";
+        default:                    return "absolute";
+    }
+}
+
+static inline bool channel_valid(const sensor_sample_t *s, therm_channel_id_t ch)
+{
+    return (s->flags[ch] & SENSOR_FLAG_VALID) != 0;
+}
+
+/**
+ * Apply the active mode's trigger condition. Only readings flagged
+ * SENSOR_FLAG_VALID (health OK) are ever acted on.
+ * @param reason  Filled with a short log description when it returns true
+ * @param lead_ms Filled with the forecast lead time, 0 unless the trigger was predictive
+ */
+static bool should_spray(const sensor_sample_t *s, char *reason, size_t reason_len, uint32_t *lead_ms)
+{
+    *lead_ms = 0;
+
+    if (s_mode == SPRAY_MODE_EFFICIENCY &&
+        channel_valid(s, THERM_CH_INLET) && channel_valid(s, THERM_CH_OUTLET) &&
+        channel_valid(s, THERM_CH_AMBIENT)) {
+        float t_in = s->temp_c[THERM_CH_INLET];
+        float t_out = s->temp_c[THERM_CH_OUTLET];
+        float rise = t_in - s->temp_c[THERM_CH_AMBIENT];
+        if (rise < SPRAY_EFFICIENCY_MIN_RISE_C) {
+            return false;
+        }
+        float efficiency = (t_in - t_out) / rise;
+        if (efficiency >= SPRAY_EFFICIENCY_MIN) {
+            return false;
+        }
+        snprintf(reason, reason_len, "efficiency %.0f%% < %.0f%% (%.1f -> %.1f°C)",
+                 efficiency * 100.0f, SPRAY_EFFICIENCY_MIN * 100.0f, t_in, t_out);
+        return true;
+    }
+
+    if (!channel_valid(s, THERMISTOR_CONTROL_CHANNEL)) {
+        return false;
+    }
+    float temp_c = s->temp_c[THERMISTOR_CONTROL_CHANNEL];
+    float trigger = (float)g_trigger_temperature;
+    if (temp_c >= trigger) {
+        snprintf(reason, reason_len, "%.1f°C >= %ld°C", temp_c, (long)g_trigger_temperature);
+        return true;
+    }
+
+#if SPRAY_PREDICTIVE
+    float rate = s->rate_c_per_s[THERMISTOR_CONTROL_CHANNEL];
+    float forecast = s->forecast_c[THERMISTOR_CONTROL_CHANNEL];
+    if ((s->flags[THERMISTOR_CONTROL_CHANNEL] & SENSOR_FLAG_TREND) &&
+        rate >= SPRAY_PREDICT_MIN_RATE && forecast >= trigger) {
+        *lead_ms = (uint32_t)((trigger - temp_c) / rate * 1000.0f);
+        snprintf(reason, reason_len, "forecast %.1f°C >= %ld°C (%.1f°C, %+.2f°C/s, lead %.1fs)",
+                 forecast, (long)g_trigger_temperature, temp_c, rate, *lead_ms / 1000.0f);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * After a predictive cycle, measure when the probe really crosses the
+ * threshold. Gives up after twice the forecast horizon (a miss).
+ */
+static void track_lead(const sensor_sample_t *s)
+{
+    if (!s_lead_pending) return;
+
+    int64_t elapsed_us = s->timestamp_us - s_lead_fire_us;
+    bool crossed = (s->flags[THERMISTOR_CONTROL_CHANNEL] & SENSOR_FLAG_VALID) &&
+                   s->temp_c[THERMISTOR_CONTROL_CHANNEL] >= (float)g_trigger_temperature;
+
+    if (crossed) {
+        s_lead_pending = false;
+        portENTER_CRITICAL(&s_lock);
+        s_stats.last_actual_lead_ms = (int32_t)(elapsed_us / 1000);
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(SPRAY_TAG, "Predictive lead: %ld ms actual, %lu ms forecast",
+                 (long)(elapsed_us / 1000), (unsigned long)s_stats.last_lead_ms);
+    } else if (elapsed_us > (int64_t)(2.0f * THERMISTOR_FORECAST_S * 1000000.0f)) {
+        s_lead_pending = false;
+        portENTER_CRITICAL(&s_lock);
+        s_stats.last_actual_lead_ms = -1;
+        s_stats.predict_misses++;
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(SPRAY_TAG, "Predictive cycle: threshold never reached");
+    }
+}
+
+/**
+ * IDLE -> SPRAYING: the relay task switches the relay ON, then finish_on()
+ * schedules the OFF edge duration_us later.
+ * @param ref_time_us Timestamp of the sample behind the decision (latency reference)
+ * @param lead_ms     Forecast lead time, 0 unless the trigger was predictive
+ * @param fallback    Cycle comes from the sensor-fault TIMED fallback
+ */
+static void start_cycle(int64_t duration_us, int64_t ref_time_us, const char *reason, uint32_t lead_ms,
+                        bool fallback)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (s_state != SPRAY_STATE_IDLE || !s_enabled || s_tank_empty) {
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    s_state = SPRAY_STATE_SPRAYING;
+    s_on_pending = true;
+    s_on_duration_us = duration_us;
+    s_on_ref_us = ref_time_us;
+    s_on_lead_ms = lead_ms;
+    s_cycle_fallback = fallback;
+    strncpy(s_on_reason, reason, sizeof(s_on_reason) - 1);
+    portEXIT_CRITICAL(&s_lock);
+
+    relay_kick();
+}
+
+/** Relay task, relay now ON: start the cycle's clock and record the ON edge. */
+static void finish_on(int64_t now)
+{
+    char reason[sizeof(s_on_reason)];
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_state != SPRAY_STATE_SPRAYING || !s_on_pending) {
+        portEXIT_CRITICAL(&s_lock);
+        return;     /* Aborted while the relay was being switched, or already done */
+    }
+    s_on_pending = false;
+    int64_t duration_us = s_on_duration_us;
+    int64_t ref_time_us = s_on_ref_us;
+    uint32_t lead_ms = s_on_lead_ms;
+    memcpy(reason, s_on_reason, sizeof(reason));
+    uint32_t latency = (uint32_t)(now - ref_time_us);
+    s_off_deadline_us = now + duration_us;
+    s_stats.cycles++;
+    s_stats.last_latency_us = latency;
+    s_stats.sum_latency_us += latency;
+    if (latency < s_stats.min_latency_us) s_stats.min_latency_us = latency;
+    if (latency > s_stats.max_latency_us) s_stats.max_latency_us = latency;
+    if (lead_ms > 0) {
+        s_stats.predicted_cycles++;
+        s_stats.last_lead_ms = lead_ms;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (lead_ms > 0) {
+        s_lead_pending = true;
+        s_lead_fire_us = ref_time_us;
+    }
+
+    esp_timer_stop(s_off_timer);
+    esp_timer_start_once(s_off_timer, (uint64_t)duration_us);
+
+    tlm_record_t rec;
+    Telemetry_Spray(&rec, now, TLM_SPRAY_ON, (uint8_t)s_mode, (uint32_t)(duration_us / 1000),
+                    (int32_t)latency, lead_ms);
+    SD_Logger_Record(&rec);
+
+    ESP_LOGI(SPRAY_TAG, "Spray ON: %s, %.1fs (latency %lu us)",
+             reason, duration_us / 1000000.0f, (unsigned long)latency);
+}
+
+/** Relay task, relay now OFF: edge error of a scheduled OFF, relay switch included. */
+static void finish_off(int64_t now)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (!s_off_pending) {
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    s_off_pending = false;
+    int32_t err = (int32_t)(now - s_off_deadline_us);
+    s_stats.last_off_error_us = err;
+    if (err > s_stats.max_off_error_us) s_stats.max_off_error_us = err;
+    portEXIT_CRITICAL(&s_lock);
+
+    tlm_record_t rec;
+    Telemetry_Spray(&rec, now, TLM_SPRAY_OFF, (uint8_t)s_mode, 0, err, 0);
+    SD_Logger_Record(&rec);
+}
+
+/**
+ * Write the relay until it matches s_state (a transition can land while
+ * a write is in flight).
+ * @return false if the expander write failed; the caller retries
+ */
+static bool relay_apply(void)
+{
+    for (;;) {
+        bool on = s_state == SPRAY_STATE_SPRAYING;
+        esp_err_t ret = relay_set(on);
+        int64_t now = esp_timer_get_time();
+        if (ret != ESP_OK) {
+            portENTER_CRITICAL(&s_lock);
+            s_stats.relay_errors++;
+            portEXIT_CRITICAL(&s_lock);
+            return false;
+        }
+        bool changed = on != s_relay_on;
+        s_relay_on = on;
+        if (on) {
+            finish_on(now);
+        } else {
+            finish_off(now);
+        }
+        if (changed) {
+            Driver_Events_Post(DRIVER_EVT_SPRAY);
+        }
+        if ((s_state == SPRAY_STATE_SPRAYING) == on) {
+            return true;
+        }
+    }
+}
+
+/**
+ * The relay's only writer. Wakes on every transition, and re-checks the
+ * relay every SPRAY_RELAY_CHECK_MS. A failed write (the shadow register
+ * keeps the old level) is retried after SPRAY_RELAY_RETRY_MS, doubling up
+ * to SPRAY_RELAY_CHECK_MS, so a lost OFF write cannot leave the pump on.
+ */
+static void relay_task_fn(void *arg)
+{
+    uint32_t wait_ms = SPRAY_RELAY_CHECK_MS;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms));
+        if (relay_apply()) {
+            wait_ms = SPRAY_RELAY_CHECK_MS;
+        } else {
+            wait_ms = (wait_ms >= SPRAY_RELAY_CHECK_MS) ? SPRAY_RELAY_RETRY_MS : wait_ms * 2;
+            if (wait_ms > SPRAY_RELAY_CHECK_MS) wait_ms = SPRAY_RELAY_CHECK_MS;
+        }
+    }
+}
+
+/**
+ * Track the control probe's health and apply SPRAY_FAULT_POLICY.
+ * @return true if the sample must not be evaluated normally
+ */
+static bool handle_sensor_fault(const sensor_sample_t *s, char *reason, size_t reason_len, bool *fire)
+{
+    uint32_t flags = s->flags[THERMISTOR_CONTROL_CHANNEL];
+    bool fault = Sensor_Health_FromFlags(flags) == SENSOR_HEALTH_FAULT;
+    *fire = false;
+
+    if (fault != s_sensor_fault) {
+        s_sensor_fault = fault;
+        if (fault) {
+            ESP_LOGW(SPRAY_TAG, "Control probe fault (%s): %s", Sensor_Health_Reason(flags),
+                     SPRAY_FAULT_POLICY == SPRAY_FAULT_TIMED ? "timed fallback spraying" : "spraying inhibited");
+        } else {
+            ESP_LOGI(SPRAY_TAG, "Control probe healthy, normal control resumed");
+        }
+    }
+    if (!fault) {
+        return false;
+    }
+
+#if SPRAY_FAULT_POLICY == SPRAY_FAULT_TIMED
+    snprintf(reason, reason_len, "timed fallback (%s)", Sensor_Health_Reason(flags));
+    *fire = true;
+#else
+    if (s_state == SPRAY_STATE_SPRAYING) {
+        spray_abort();
+    }
+#endif
+    return true;
+}
+
+/***********************
+ *  TIMER CALLBACKS
+ ***********************/
+static void off_timer_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t interval_us = (int64_t)g_sprayer_interval * 1000000LL;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_state != SPRAY_STATE_SPRAYING || now < s_off_deadline_us) {
+        portEXIT_CRITICAL(&s_lock);
+        return;     /* Stale callback from an aborted cycle */
+    }
+    /* DUTY: the modulation period spaces the pulses, no hold-off. The
+     * TIMED fault fallback has no period of its own and always needs one */
+    bool holdoff = s_mode != SPRAY_MODE_DUTY || s_cycle_fallback;
+    s_state = holdoff ? SPRAY_STATE_HOLDOFF : SPRAY_STATE_IDLE;
+    s_holdoff_deadline_us = now + interval_us;
+    s_off_pending = true;               /* Edge error is taken after the relay write */
+    portEXIT_CRITICAL(&s_lock);
+
+    relay_kick();
+    if (holdoff) {
+        esp_timer_start_once(s_holdoff_timer, (uint64_t)interval_us);
+    }
+}
+
+static void holdoff_timer_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_state == SPRAY_STATE_HOLDOFF && now >= s_holdoff_deadline_us) {
+        s_state = SPRAY_STATE_IDLE;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * DUTY mode: one controller step per modulation period, on the esp_timer
+ * task so the loop rate does not depend on the driver or UI tasks.
+ */
+static void pid_timer_cb(void *arg)
+{
+    if (s_mode != SPRAY_MODE_DUTY) {
+        return;
+    }
+
+    sensor_sample_t sample;
+    if (s_sensor_fault || !s_enabled || s_tank_empty || !Sensor_Ring_Latest(&sample) ||
+        !(sample.flags[THERMISTOR_CONTROL_CHANNEL] & SENSOR_FLAG_VALID)) {
+        /* No trustworthy reading, or spraying inhibited: do not wind up */
+        Spray_PID_Reset(&s_pid);
+        s_duty = 0.0f;
+        return;
+    }
+
+    float error = sample.temp_c[THERMISTOR_CONTROL_CHANNEL] - (float)g_trigger_temperature;
+    float rate = (sample.flags[THERMISTOR_CONTROL_CHANNEL] & SENSOR_FLAG_TREND)
+               ? sample.rate_c_per_s[THERMISTOR_CONTROL_CHANNEL] : 0.0f;
+    float duty = Spray_PID_Update(&s_pid, error, rate, SPRAY_PID_PERIOD_MS / 1000.0f);
+    s_duty = duty;
+
+    uint32_t on_ms = Spray_PID_PulseMs(duty, SPRAY_PID_PERIOD_MS, SPRAY_PID_MIN_PULSE_MS);
+    if (on_ms == 0) {
+        return;
+    }
+    int64_t duration_us = (int64_t)on_ms * 1000;
+
+    /* Still ON from a full-duty period: move the OFF edge instead of
+     * letting the relay drop for one period */
+    portENTER_CRITICAL(&s_lock);
+    bool extend = s_state == SPRAY_STATE_SPRAYING && !s_on_pending;
+    if (extend) {
+        s_off_deadline_us = esp_timer_get_time() + duration_us;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (extend) {
+        esp_timer_stop(s_off_timer);
+        esp_timer_start_once(s_off_timer, (uint64_t)duration_us);
+        return;
+    }
+
+    char reason[64];
+    snprintf(reason, sizeof(reason), "duty %.0f%% (%+.1f°C, %+.2f°C/s)", duty * 100.0f, error, rate);
+    start_cycle(duration_us, sample.timestamp_us, reason, 0, false);
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Spray_Init(void)
+{
+    if (relay_set(false) != ESP_OK) {
+        ESP_LOGW(SPRAY_TAG, "Relay OFF write failed, the relay task retries it");
+    }
+
+    const esp_timer_create_args_t off_args = {
+        .callback = off_timer_cb,
+        .name = "spray_off",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&off_args, &s_off_timer));
+
+    const esp_timer_create_args_t holdoff_args = {
+        .callback = holdoff_timer_cb,
+        .name = "spray_holdoff",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&holdoff_args, &s_holdoff_timer));
+
+    const spray_pid_cfg_t pid_cfg = {
+        .kp = SPRAY_PID_KP,
+        .ki = SPRAY_PID_KI,
+        .kd = SPRAY_PID_KD,
+    };
+    Spray_PID_Init(&s_pid, &pid_cfg);
+
+    const esp_timer_create_args_t pid_args = {
+        .callback = pid_timer_cb,
+        .name = "spray_pid",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&pid_args, &s_pid_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(s_pid_timer, (uint64_t)SPRAY_PID_PERIOD_MS * 1000));
+
+    xTaskCreatePinnedToCore(relay_task_fn, "spray_relay", SPRAY_RELAY_TASK_STACK, NULL, SPRAY_RELAY_TASK_PRIORITY,
+                            &s_relay_task, 0);
+    relay_kick();
+
+    ESP_LOGI(SPRAY_TAG, "Spray engine initialized: relay on EXIO%d, %s mode",
+             SPRAY_RELAY_EXIO, mode_name(s_mode));
+}
+
+void Spray_Evaluate(const sensor_sample_t *sample)
+{
+    char reason[96];
+    bool fire;
+    bool fallback = false;
+    uint32_t lead_ms = 0;
+
+    track_lead(sample);
+    if (handle_sensor_fault(sample, reason, sizeof(reason), &fire)) {
+        if (!fire || s_state != SPRAY_STATE_IDLE) return;
+        fallback = true;
+    } else if (s_mode == SPRAY_MODE_DUTY) {
+        return;     /* Pulses come from pid_timer_cb */
+    } else if (s_state != SPRAY_STATE_IDLE || !should_spray(sample, reason, sizeof(reason), &lead_ms)) {
+        return;
+    }
+
+    start_cycle((int64_t)(g_sprayer_duration * 1000000.0f), sample->timestamp_us, reason, lead_ms, fallback);
+}
+
+void Spray_SetMode(spray_mode_t mode)
+{
+    if (mode == s_mode) return;
+
+    /* A cycle started under the old mode's timing rules is cut short */
+    s_mode = mode;
+    spray_abort();
+    Spray_PID_Reset(&s_pid);
+    s_duty = 0.0f;
+    ESP_LOGI(SPRAY_TAG, "Mode: %s", mode_name(mode));
+}
+
+spray_mode_t Spray_GetMode(void)
+{
+    return s_mode;
+}
+
+bool Spray_SensorFault(void)
+{
+    return s_sensor_fault;
+}
+
+float Spray_GetDuty(void)
+{
+    return s_duty;
+}
+
+void Spray_SetEnabled(bool enabled)
+{
+    s_enabled = enabled;
+    if (!enabled) {
+        spray_abort();
+    }
+}
+
+void Spray_SetTankEmpty(bool is_empty)
+{
+    s_tank_empty = is_empty;
+    if (is_empty) {
+        spray_abort();
+    }
+}
+
+bool Spray_IsEnabled(void)
+{
+    return s_enabled;
+}
+
+bool Spray_IsTankEmpty(void)
+{
+    return s_tank_empty;
+}
+
+bool Spray_IsActive(void)
+{
+    return s_relay_on;
+}
+
+spray_state_t Spray_GetState(void)
+{
+    return s_state;
+}
+
+void Spray_GetStats(spray_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+    if (out->cycles == 0) {
+        out->min_latency_us = 0;
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Sensor_Ring.h"
+
+/***********************
+ *  PIN CONFIGURATION
+ *  GPIO19/20 are both thermistor inputs, so the relay driver hangs off the
+ *  TCA9554 expander. Its pins come up as inputs with pull-ups and the
+ *  output latch resets to 1, so an active LOW driver stays off until
+ *  Spray_Init() runs.
+ ***********************/
+#define SPRAY_RELAY_EXIO        TCA9554_EXIO5   // EXIO5 — spray pump / solenoid relay
+#define SPRAY_RELAY_ON_LEVEL    0               // Relay driver is active LOW
+#define SPRAY_RELAY_TASK_PRIORITY   5           // Below the I2C bus task, with touch
+#define SPRAY_RELAY_TASK_STACK      4096        // Runs the ON log line (float formatting)
+#define SPRAY_RELAY_RETRY_MS        20          // First retry of a failed relay write, doubling...
+#define SPRAY_RELAY_CHECK_MS        1000        // ...up to this, also the idle re-check period
+
+/***********************
+ *  CONTROL MODE
+ *  ABSOLUTE:   spray when the control probe (intercooler outlet) reaches
+ *              g_trigger_temperature.
+ *  EFFICIENCY: spray when intercooler efficiency
+ *                  (T_inlet - T_outlet) / (T_inlet - T_ambient)
+ *              drops below SPRAY_EFFICIENCY_MIN while the charge is at least
+ *              SPRAY_EFFICIENCY_MIN_RISE_C above ambient. Falls back to
+ *              ABSOLUTE for any sample where one of the three probes is invalid.
+ *  DUTY:       closed loop. Every SPRAY_PID_PERIOD_MS a PID on
+ *              (control probe - g_trigger_temperature) picks the ON time for
+ *              that period (Spray_PID.h). Pulses shorter than
+ *              SPRAY_PID_MIN_PULSE_MS are skipped; g_sprayer_duration and
+ *              g_sprayer_interval are not used. Tune with tools/spray_sim.
+ *
+ *  The default gains are a PID. The small integral term removes the
+ *  steady offset above the trigger that a PD leaves under long pulls,
+ *  and the duty clamp's anti-windup keeps it bounded. tools/spray_sim,
+ *  DUTY against ABSOLUTE:
+ *    pulls to 70 °C (road):   water 45.9 s vs 64.0 s, over-trigger 51.8 vs 41.3 °C·s
+ *    pulls to 120 °C (track): water 346 s vs 128 s,   over-trigger 936 vs 4276 °C·s,
+ *                             peak 47.2 vs 57.4 °C
+ *  DUTY saves about a quarter of the water at mild over-temperature. Under
+ *  sustained boost it spends 2.7x the water to hold the core ~10 °C cooler.
+ *  With KI = 0 (a PD) road use drops to 27.5 s but over-trigger grows
+ *  to 214.5 °C·s.
+ ***********************/
+#define SPRAY_DEFAULT_MODE          SPRAY_MODE_ABSOLUTE
+#define SPRAY_EFFICIENCY_MIN        0.60f   // Spray below 60 % efficiency
+#define SPRAY_EFFICIENCY_MIN_RISE_C 10.0f   // Ignore efficiency with little boost heat
+
+#define SPRAY_PID_PERIOD_MS         10000   // Modulation period / controller rate
+#define SPRAY_PID_MIN_PULSE_MS      500     // Shortest useful pump / nozzle pulse
+#define SPRAY_PID_KP                0.08f   // Duty per °C above the trigger
+#define SPRAY_PID_KI                0.005f  // Duty per °C·s
+#define SPRAY_PID_KD                0.30f   // Duty per °C/s of rise
+
+/***********************
+ *  PREDICTIVE TRIGGER (ABSOLUTE mode)
+ *  Also fire when the control probe's forecast (THERMISTOR_FORECAST_S
+ *  ahead, see Thermistor.h) reaches g_trigger_temperature while it is
+ *  rising at least SPRAY_PREDICT_MIN_RATE, so the spray starts before the
+ *  core heat-soaks. Predicted and measured lead times go to the stats.
+ ***********************/
+#define SPRAY_PREDICTIVE            1
+#define SPRAY_PREDICT_MIN_RATE      0.2f    // °C/s; ignore forecasts on a near-flat trend
+
+/***********************
+ *  SENSOR FAULT POLICY
+ *  Applied while the control probe has a latched fault (Sensor_Health.h).
+ *  INHIBIT: cut any running cycle and never spray (default; fails dry).
+ *  TIMED:   spray g_sprayer_duration every g_sprayer_interval regardless
+ *           of temperature, for setups where missing a spray is worse.
+ *  Suspect readings (not yet confirmed) are simply ignored in both cases.
+ ***********************/
+#define SPRAY_FAULT_INHIBIT     0
+#define SPRAY_FAULT_TIMED       1
+#define SPRAY_FAULT_POLICY      SPRAY_FAULT_INHIBIT
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+
+/** Trigger condition, see CONTROL MODE */
+typedef enum {
+    SPRAY_MODE_ABSOLUTE,
+    SPRAY_MODE_EFFICIENCY,
+    SPRAY_MODE_DUTY,
+} spray_mode_t;
+
+/** Spray engine state */
+typedef enum {
+    SPRAY_STATE_IDLE,       // Relay off, ready to fire on the next hot sample
+    SPRAY_STATE_SPRAYING,   // Relay on, OFF edge scheduled
+    SPRAY_STATE_HOLDOFF,    // Relay off, waiting out g_sprayer_interval
+} spray_state_t;
+
+/** Timing counters exposed for diagnostics and logging */
+typedef struct {
+    uint32_t cycles;            // Spray cycles started since boot
+    uint32_t last_latency_us;   // Sample timestamp -> relay ON edge, last cycle
+    uint32_t min_latency_us;    // Best trigger-to-relay latency seen
+    uint32_t max_latency_us;    // Worst trigger-to-relay latency seen
+    uint64_t sum_latency_us;    // Sum of all latencies (divide by cycles for mean)
+    int32_t  last_off_error_us; // Relay OFF written - scheduled OFF edge, last cycle
+    int32_t  max_off_error_us;  // Worst OFF edge error seen
+    uint32_t predicted_cycles;  // Cycles started on the forecast, before the threshold
+    uint32_t last_lead_ms;      // Forecast lead time of the last predictive cycle
+    int32_t  last_actual_lead_ms; // Fire -> probe actually crossing, -1 if it never did
+    uint32_t predict_misses;    // Predictive cycles whose crossing never came
+    uint32_t relay_errors;      // Failed relay writes (each one retried)
+} spray_stats_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * Configure the relay EXIO (off) and create the one-shot edge timers.
+ * Must be called after EXIO_Init() and before any other Spray_ function.
+ */
+void Spray_Init(void);
+
+/**
+ * Feed a multi-channel sensor sample to the spray engine.
+ * If the engine is idle, enabled and the tank is not empty, a sample that
+ * meets the active mode's trigger condition has the relay task switch the
+ * relay ON at once, and the OFF edge is scheduled g_sprayer_duration after
+ * the relay write on an esp_timer one-shot alarm. After the OFF edge the engine holds off for
+ * g_sprayer_interval seconds.
+ * @param sample  Scan from the sensor ring; timestamp_us is the latency reference
+ */
+void Spray_Evaluate(const sensor_sample_t *sample);
+
+/** Select the trigger condition. Takes effect on the next sample. */
+void Spray_SetMode(spray_mode_t mode);
+
+/** @return active trigger condition */
+spray_mode_t Spray_GetMode(void);
+
+/** @return true while the control probe has a latched fault and SPRAY_FAULT_POLICY applies */
+bool Spray_SensorFault(void);
+
+/** @return Last DUTY mode controller output (0..1), 0 in other modes */
+float Spray_GetDuty(void);
+
+/**
+ * Enable or disable spraying. Disabling cuts a running ON phase and
+ * forces the relay off; the cycle's hold-off still runs to its end.
+ */
+void Spray_SetEnabled(bool enabled);
+
+/**
+ * Inhibit spraying while the tank is empty. A running ON phase is cut
+ * short, the hold-off after it is kept.
+ */
+void Spray_SetTankEmpty(bool is_empty);
+
+/** @return false after Spray_SetEnabled(false) */
+bool Spray_IsEnabled(void);
+
+/** @return true while Spray_SetTankEmpty(true) inhibits spraying */
+bool Spray_IsTankEmpty(void);
+
+/** @return true while the relay is energised (last level the expander acknowledged) */
+bool Spray_IsActive(void);
+
+/** @return current engine state */
+spray_state_t Spray_GetState(void);
+
+/**
+ * Copy the latency / edge timing counters.
+ * @param out Destination, must not be NULL
+ */
+void Spray_GetStats(spray_stats_t *out);
@@ -0,0 +1,50 @@
+#include "Spray_PID.h"
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Spray_PID_Init(spray_pid_t *pid, const spray_pid_cfg_t *cfg)
+{
+    pid->cfg = *cfg;
+    Spray_PID_Reset(pid);
+}
+
+void Spray_PID_Reset(spray_pid_t *pid)
+{
+    pid->integ = 0.0f;
+    pid->last_duty = 0.0f;
+}
+
+float Spray_PID_Update(spray_pid_t *pid, float error_c, float rate_c_per_s, float dt_s)
+{
+    float p = pid->cfg.kp * error_c;
+    float d = pid->cfg.kd * rate_c_per_s;
+    float u = p + pid->integ + d;
+
+    /* Integrate only if that does not drive further into saturation */
+    float di = pid->cfg.ki * error_c * dt_s;
+    if (!((u >= 1.0f && di > 0.0f) || (u <= 0.0f && di < 0.0f))) {
+        pid->integ += di;
+        /* The integrator alone never needs more than the full output range */
+        if (pid->integ > 1.0f) pid->integ = 1.0f;
+        if (pid->integ < 0.0f) pid->integ = 0.0f;
+        u = p + pid->integ + d;
+    }
+
+    if (u > 1.0f) u = 1.0f;
+    if (u < 0.0f) u = 0.0f;
+    pid->last_duty = u;
+    return u;
+}
+
+uint32_t Spray_PID_PulseMs(float duty, uint32_t period_ms, uint32_t min_pulse_ms)
+{
+    uint32_t on_ms = (uint32_t)(duty * (float)period_ms + 0.5f);
+    if (on_ms < min_pulse_ms) {
+        return 0;
+    }
+    if (on_ms + min_pulse_ms > period_ms) {
+        return period_ms;
+    }
+    return on_ms;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+/***********************
+ *  DUTY-CYCLE CONTROLLER
+ *  PID on the control probe's error above the trigger temperature, output
+ *  is the spray duty cycle (0..1) for one modulation period. Plain C with
+ *  no ESP-IDF dependencies, so tools/spray_sim can link it on the host.
+ *
+ *  - Derivative acts on the measurement's slope (dT/dt from the trend fit),
+ *    not on the error, so changing the setpoint does not kick the output.
+ *  - Anti-windup by conditional integration: the integrator only moves
+ *    when the output is not saturated in the direction it would push.
+ ***********************/
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct {
+    float kp;               // Duty per °C above the trigger
+    float ki;               // Duty per °C·s
+    float kd;               // Duty per °C/s of rise
+} spray_pid_cfg_t;
+
+typedef struct {
+    spray_pid_cfg_t cfg;
+    float integ;            // Integrator contribution, already scaled by ki (duty)
+    float last_duty;        // Output of the last update
+} spray_pid_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Set gains and clear the integrator */
+void Spray_PID_Init(spray_pid_t *pid, const spray_pid_cfg_t *cfg);
+
+/** Clear the integrator (e.g. when the mode is entered or control is inhibited) */
+void Spray_PID_Reset(spray_pid_t *pid);
+
+/**
+ * Run one controller step.
+ * @param error_c       Temperature minus setpoint in °C (positive = too hot)
+ * @param rate_c_per_s  Measured dT/dt in °C/s (0 if unknown)
+ * @param dt_s          Time since the previous step in seconds
+ * @return Duty cycle 0..1
+ */
+float Spray_PID_Update(spray_pid_t *pid, float error_c, float rate_c_per_s, float dt_s);
+
+/**
+ * Turn a duty cycle into a relay ON time for one period, honouring the
+ * minimum pulse: shorter pulses are dropped, and an OFF gap shorter than
+ * min_pulse_ms is closed to full ON.
+ * @return ON time in ms (0..period_ms)
+ */
+uint32_t Spray_PID_PulseMs(float duty, uint32_t period_ms, uint32_t min_pulse_ms);
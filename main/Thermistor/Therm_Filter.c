@@ -0,0 +1,89 @@
+#include "Therm_Filter.h"
+
+/***********************
+ *  MEDIAN
+ *  sorted[] is kept ordered by removing the value that leaves the window
+ *  and inserting the new one, so each step is one pass over at most
+ *  THERM_FILTER_MEDIAN_MAX entries instead of a sort.
+ ***********************/
+static int16_t median_step(therm_filter_t *f, int16_t x)
+{
+    uint8_t n = f->cfg.median_len;
+    if (n <= 1) return x;
+
+    int16_t old = f->window[f->pos];
+    f->window[f->pos] = x;
+    if (++f->pos >= n) f->pos = 0;
+
+    /* Remove old */
+    uint8_t i = 0;
+    while (i < n - 1 && f->sorted[i] != old) i++;
+    for (; i < n - 1; i++) f->sorted[i] = f->sorted[i + 1];
+
+    /* Insert x into the first n - 1 entries */
+    i = n - 1;
+    while (i > 0 && f->sorted[i - 1] > x) {
+        f->sorted[i] = f->sorted[i - 1];
+        i--;
+    }
+    f->sorted[i] = x;
+
+    return f->sorted[n / 2];
+}
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Therm_Filter_Init(therm_filter_t *f, const therm_filter_cfg_t *cfg)
+{
+    f->cfg = *cfg;
+    if (f->cfg.median_len > THERM_FILTER_MEDIAN_MAX) f->cfg.median_len = THERM_FILTER_MEDIAN_MAX;
+    if (f->cfg.median_len == 0) f->cfg.median_len = 1;
+    f->cfg.median_len |= 1;     /* Odd, so the median is a sample */
+    if (f->cfg.alpha_q15 == 0 || f->cfg.alpha_q15 > THERM_FILTER_ALPHA_ONE) {
+        f->cfg.alpha_q15 = THERM_FILTER_ALPHA_ONE;
+    }
+    Therm_Filter_Reset(f);
+}
+
+void Therm_Filter_Reset(therm_filter_t *f)
+{
+    f->pos = 0;
+    f->primed = false;
+    f->iir_q8 = 0;
+    f->median = 0;
+    f->out = 0;
+}
+
+int32_t Therm_Filter_Step(therm_filter_t *f, int16_t centi_c)
+{
+    if (!f->primed) {
+        for (uint8_t i = 0; i < f->cfg.median_len; i++) {
+            f->window[i] = centi_c;
+            f->sorted[i] = centi_c;
+        }
+        f->iir_q8 = (int32_t)centi_c << 8;
+        f->median = centi_c;
+        f->out = centi_c;
+        f->primed = true;
+        return f->out;
+    }
+
+    int32_t m = median_step(f, centi_c);
+    f->median = m;
+
+    /* One-pole IIR: y += alpha * (x - y) */
+    int32_t err_q8 = (m << 8) - f->iir_q8;
+    f->iir_q8 += (int32_t)(((int64_t)err_q8 * f->cfg.alpha_q15) >> 15);
+    int32_t y = (f->iir_q8 + 128) >> 8;
+
+    /* Slew-rate limit relative to the previous output */
+    int32_t limit = f->cfg.slew_centi_c;
+    if (limit > 0) {
+        if (y > f->out + limit) y = f->out + limit;
+        else if (y < f->out - limit) y = f->out - limit;
+    }
+
+    f->out = y;
+    return y;
+}
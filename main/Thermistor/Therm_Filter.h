@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/***********************
+ *  FILTER CHAIN
+ *  Runs once per published reading, per channel, on temperatures in
+ *  0.01 °C:  sliding median -> one-pole IIR -> slew-rate limit.
+ *  The median removes ignition spikes (any burst shorter than half the
+ *  window), the IIR smooths the remaining jitter and the slew limit caps
+ *  what a single outlier that gets through can do. Fixed-size state,
+ *  integer only, no allocation; cost is bounded by THERM_FILTER_MEDIAN_MAX.
+ ***********************/
+#define THERM_FILTER_MEDIAN_MAX     9       // Largest supported median window (odd)
+#define THERM_FILTER_ALPHA_ONE      32768   // alpha_q15 that disables the IIR
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct {
+    uint8_t  median_len;        // Median window, odd, 1..THERM_FILTER_MEDIAN_MAX (1 = off)
+    uint16_t alpha_q15;         // IIR weight of the new value, 1..THERM_FILTER_ALPHA_ONE (ALPHA_ONE = off)
+    int32_t  slew_centi_c;      // Max change per reading in 0.01 °C (0 = off)
+} therm_filter_cfg_t;
+
+typedef struct {
+    therm_filter_cfg_t cfg;
+    int16_t  window[THERM_FILTER_MEDIAN_MAX];   // Last median_len inputs, arrival order
+    int16_t  sorted[THERM_FILTER_MEDIAN_MAX];   // Same values, ascending
+    uint8_t  pos;               // Oldest entry in window[]
+    bool     primed;            // false until the first input seeds every stage
+    int32_t  iir_q8;            // IIR state, 0.01 °C with 8 fractional bits
+    int32_t  median;            // Last median stage output, 0.01 °C (input of the health rate check)
+    int32_t  out;               // Last output, 0.01 °C
+} therm_filter_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Set the configuration and clear the state */
+void Therm_Filter_Init(therm_filter_t *f, const therm_filter_cfg_t *cfg);
+
+/** Forget history; the next input seeds every stage (e.g. after a probe fault) */
+void Therm_Filter_Reset(therm_filter_t *f);
+
+/**
+ * Push one reading through the chain.
+ * @param centi_c Input in 0.01 °C
+ * @return Filtered value in 0.01 °C
+ */
+int32_t Therm_Filter_Step(therm_filter_t *f, int16_t centi_c);
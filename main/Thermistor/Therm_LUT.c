@@ -0,0 +1,76 @@
+#include "Therm_LUT.h"
+#include <math.h>
+
+#define ADC_FULL_SCALE_CODE     ((1 << THERM_LUT_ADC_BITS) - 1)
+#define ADC_FULL_SCALE_MV       THERM_LUT_FULL_SCALE_MV
+#define KELVIN_OFFSET           273.15f
+
+/***********************
+ *  FLOAT MODEL
+ ***********************/
+float Therm_Model_TempC(const therm_params_t *p, float voltage_mv)
+{
+    float voltage_v = voltage_mv / 1000.0f;
+
+    /* Voltage divider: 3.3V --- [R_series] --- ADC --- [NTC] --- GND
+     * V_adc = 3.3 * R_ntc / (R_series + R_ntc)
+     * R_ntc = R_series * V_adc / (3.3 - V_adc) */
+    if (voltage_v <= 0.01f || voltage_v >= 3.29f) {
+        return -999.0f;
+    }
+
+    float r_ntc = p->series_r * voltage_v / (3.3f - voltage_v);
+    float inv_t;
+
+    if (p->model == THERM_MODEL_STEINHART_HART) {
+        /* Full Steinhart-Hart: 1/T = A + B*ln(R) + C*ln(R)^3 */
+        float ln_r = logf(r_ntc);
+        inv_t = p->sh_a + p->sh_b * ln_r + p->sh_c * ln_r * ln_r * ln_r;
+    } else {
+        /* Simplified (Beta equation): 1/T = 1/T0 + (1/B) * ln(R/R0) */
+        inv_t = logf(r_ntc / p->nominal_r) / p->beta;
+        inv_t += 1.0f / (p->nominal_t + KELVIN_OFFSET);
+    }
+
+    return (1.0f / inv_t) - KELVIN_OFFSET;
+}
+
+/***********************
+ *  TABLE
+ ***********************/
+void Therm_LUT_Build(therm_lut_t *lut, const therm_params_t *p)
+{
+    for (int i = 0; i < THERM_LUT_SIZE; i++) {
+        int code = i << THERM_LUT_SHIFT;
+        if (code > ADC_FULL_SCALE_CODE) code = ADC_FULL_SCALE_CODE;
+
+        float mv = (float)code * ADC_FULL_SCALE_MV / (float)ADC_FULL_SCALE_CODE;
+        float t = Therm_Model_TempC(p, mv);
+        if (t < -300.0f || t > 320.0f) {
+            lut->centi_c[i] = THERM_LUT_INVALID;
+        } else {
+            lut->centi_c[i] = (int16_t)lrintf(t * 100.0f);
+        }
+    }
+}
+
+void Therm_LUT_Check(const therm_lut_t *lut, const therm_params_t *p, float min_c, float max_c,
+                     therm_lut_check_t *out)
+{
+    out->max_err_c = 0.0f;
+    out->worst_code = 0;
+    out->compared = 0;
+
+    for (int code = 0; code <= ADC_FULL_SCALE_CODE; code++) {
+        float ref = Therm_Model_TempC(p, (float)code * ADC_FULL_SCALE_MV / (float)ADC_FULL_SCALE_CODE);
+        int16_t lut_c = Therm_LUT_Lookup(lut, (uint32_t)code << THERM_LUT_FRAC_BITS);
+        if (ref < min_c || ref > max_c || lut_c == THERM_LUT_INVALID) continue;
+
+        float err = fabsf(lut_c / 100.0f - ref);
+        if (err > out->max_err_c) {
+            out->max_err_c = err;
+            out->worst_code = code;
+        }
+        out->compared++;
+    }
+}
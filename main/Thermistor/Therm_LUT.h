@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+/***********************
+ *  TABLE GEOMETRY
+ *  One entry every 8 ADC codes (513 x int16 = ~1 KB). Linear
+ *  interpolation between entries stays within 0.07 °C of the float
+ *  model over -20..150 °C for a 100K/3950 NTC on a 100K divider (0.09 °C
+ *  with the Steinhart-Hart defaults); the worst case is at the hot end.
+ *  tools/therm_bench checks both over the whole 0-3.3 V input.
+ ***********************/
+#define THERM_LUT_ADC_BITS      12
+#define THERM_LUT_FULL_SCALE_MV 3300.0f                                     // Voltage of the top ADC code
+#define THERM_LUT_SHIFT         3                                           // log2(codes per entry)
+#define THERM_LUT_SIZE          (((1 << THERM_LUT_ADC_BITS) >> THERM_LUT_SHIFT) + 1)
+#define THERM_LUT_FRAC_BITS     8                                           // fractional bits of code_q8
+#define THERM_LUT_INVALID       INT16_MIN                                   // open / short circuit
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef enum {
+    THERM_MODEL_BETA,           // 1/T = 1/T0 + ln(R/R0)/B
+    THERM_MODEL_STEINHART_HART, // 1/T = A + B*ln(R) + C*ln(R)^3
+} therm_model_t;
+
+typedef struct {
+    therm_model_t model;
+    float series_r;     // Divider resistor (ohms), 3.3V --- [series_r] --- ADC --- [NTC] --- GND
+    float nominal_r;    // Beta: resistance at nominal_t (ohms)
+    float nominal_t;    // Beta: nominal temperature (°C)
+    float beta;         // Beta: coefficient
+    float sh_a;         // Steinhart-Hart A
+    float sh_b;         // Steinhart-Hart B
+    float sh_c;         // Steinhart-Hart C
+} therm_params_t;
+
+typedef struct {
+    int16_t centi_c[THERM_LUT_SIZE];    // Temperature in 0.01 °C per table entry
+} therm_lut_t;
+
+typedef struct {
+    float max_err_c;    // Worst |LUT - model| over the compared codes
+    int   worst_code;   // ADC code where it occurs
+    int   compared;     // Codes inside the temperature range with a valid entry
+} therm_lut_check_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/**
+ * Reference float conversion (divide + logf per call)
+ * @param p          Thermistor and divider parameters
+ * @param voltage_mv ADC voltage in mV
+ * @return Temperature in °C, or -999.0f if the voltage is outside the divider's valid range
+ */
+float Therm_Model_TempC(const therm_params_t *p, float voltage_mv);
+
+/**
+ * Fill a table from the float model. Run once at init.
+ */
+void Therm_LUT_Build(therm_lut_t *lut, const therm_params_t *p);
+
+/**
+ * Fixed-point lookup with linear interpolation. No float, no divide.
+ * @param code_q8 ADC code with THERM_LUT_FRAC_BITS fractional bits
+ *                (e.g. (sum_raw << 8) / count for an averaged block)
+ * @return Temperature in 0.01 °C, or THERM_LUT_INVALID
+ */
+static inline int16_t Therm_LUT_Lookup(const therm_lut_t *lut, uint32_t code_q8)
+{
+    const uint32_t shift = THERM_LUT_SHIFT + THERM_LUT_FRAC_BITS;
+    uint32_t idx = code_q8 >> shift;
+    if (idx >= THERM_LUT_SIZE - 1) {
+        return lut->centi_c[THERM_LUT_SIZE - 1];
+    }
+    int32_t a = lut->centi_c[idx];
+    int32_t b = lut->centi_c[idx + 1];
+    if (a == THERM_LUT_INVALID || b == THERM_LUT_INVALID) {
+        return THERM_LUT_INVALID;
+    }
+    int32_t frac = (int32_t)(code_q8 & ((1u << shift) - 1));
+    return (int16_t)(a + (((b - a) * frac) >> shift));
+}
+
+/**
+ * Compare the table against the float model for every ADC code over
+ * 0-3.3V whose model temperature is within min_c..max_c.
+ * Plain C, so the same check runs at boot (Therm_SelfTest.h) and on the
+ * host (tools/therm_bench).
+ */
+void Therm_LUT_Check(const therm_lut_t *lut, const therm_params_t *p, float min_c, float max_c,
+                     therm_lut_check_t *out);
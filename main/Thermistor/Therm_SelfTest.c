@@ -0,0 +1,105 @@
+#include "Therm_SelfTest.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+static const char *SELFTEST_TAG = "Therm_SelfTest";
+
+#define ADC_FULL_SCALE_CODE     ((1 << THERM_LUT_ADC_BITS) - 1)
+
+/***********************
+ *  LOOKUP TABLE
+ ***********************/
+void Therm_LUT_SelfTest(const therm_lut_t *lut, const therm_params_t *p)
+{
+    volatile float sink_f = 0.0f;
+    volatile int32_t sink_i = 0;
+
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    for (int code = 0; code <= ADC_FULL_SCALE_CODE; code++) {
+        sink_f = Therm_Model_TempC(p, (float)code * THERM_LUT_FULL_SCALE_MV / (float)ADC_FULL_SCALE_CODE);
+    }
+    uint32_t t1 = esp_cpu_get_cycle_count();
+    for (int code = 0; code <= ADC_FULL_SCALE_CODE; code++) {
+        sink_i = Therm_LUT_Lookup(lut, (uint32_t)code << THERM_LUT_FRAC_BITS);
+    }
+    uint32_t t2 = esp_cpu_get_cycle_count();
+    (void)sink_f;
+    (void)sink_i;
+
+    therm_lut_check_t chk;
+    Therm_LUT_Check(lut, p, -20.0f, 150.0f, &chk);
+
+    ESP_LOGI(SELFTEST_TAG, "LUT: %d codes in -20..150 C, max error %.3f C at code %d",
+             chk.compared, chk.max_err_c, chk.worst_code);
+    ESP_LOGI(SELFTEST_TAG, "LUT: float %lu cycles/conv, LUT %lu cycles/conv",
+             (unsigned long)((t1 - t0) / (ADC_FULL_SCALE_CODE + 1)),
+             (unsigned long)((t2 - t1) / (ADC_FULL_SCALE_CODE + 1)));
+}
+
+/***********************
+ *  FILTER
+ ***********************/
+#define FILTER_TEST_SAMPLES        600         // 60 s at 10 Hz
+#define FILTER_TEST_THRESHOLD      4000        // 40.00 °C trigger
+#define FILTER_TEST_START          3500        // Ramp 35 -> 45 °C across the trace
+#define FILTER_TEST_END            4500
+#define FILTER_TEST_JITTER         30          // ±0.30 °C uniform noise
+#define FILTER_TEST_SPIKE_EVERY    23          // Samples between ignition spikes
+#define FILTER_TEST_SPIKE_SIZE     800         // ±8 °C
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/** Count threshold crossings; a clean ramp crosses once */
+static int count_crossings(const int32_t *v, int n)
+{
+    int crossings = 0;
+    bool above = v[0] >= FILTER_TEST_THRESHOLD;
+    for (int i = 1; i < n; i++) {
+        bool now = v[i] >= FILTER_TEST_THRESHOLD;
+        if (now != above) crossings++;
+        above = now;
+    }
+    return crossings;
+}
+
+void Therm_Filter_SelfTest(const therm_filter_cfg_t *cfg)
+{
+    static int16_t trace[FILTER_TEST_SAMPLES];
+    static int32_t raw[FILTER_TEST_SAMPLES];
+    static int32_t filtered[FILTER_TEST_SAMPLES];
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < FILTER_TEST_SAMPLES; i++) {
+        int32_t t = FILTER_TEST_START + (FILTER_TEST_END - FILTER_TEST_START) * i / (FILTER_TEST_SAMPLES - 1);
+        t += (int32_t)(lcg_next(&seed) % (2 * FILTER_TEST_JITTER + 1)) - FILTER_TEST_JITTER;
+        if (i % FILTER_TEST_SPIKE_EVERY == 0) {
+            t += (lcg_next(&seed) & 1) ? FILTER_TEST_SPIKE_SIZE : -FILTER_TEST_SPIKE_SIZE;
+        }
+        trace[i] = (int16_t)t;
+        raw[i] = t;
+    }
+
+    therm_filter_t f;
+    Therm_Filter_Init(&f, cfg);
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < FILTER_TEST_SAMPLES; i++) {
+        filtered[i] = Therm_Filter_Step(&f, trace[i]);
+    }
+    uint32_t t1 = esp_cpu_get_cycle_count();
+
+    /* Lag: first sample at or above the threshold, filtered vs noise-free ramp */
+    int ideal = (FILTER_TEST_THRESHOLD - FILTER_TEST_START) * (FILTER_TEST_SAMPLES - 1) / (FILTER_TEST_END - FILTER_TEST_START);
+    int first = -1;
+    for (int i = 0; i < FILTER_TEST_SAMPLES && first < 0; i++) {
+        if (filtered[i] >= FILTER_TEST_THRESHOLD) first = i;
+    }
+
+    ESP_LOGI(SELFTEST_TAG, "Filter: threshold crossings raw %d, filtered %d (ideal 1)",
+             count_crossings(raw, FILTER_TEST_SAMPLES), count_crossings(filtered, FILTER_TEST_SAMPLES));
+    ESP_LOGI(SELFTEST_TAG, "Filter: first trigger at sample %d (noise-free %d), %lu cycles/sample",
+             first, ideal, (unsigned long)((t1 - t0) / FILTER_TEST_SAMPLES));
+}
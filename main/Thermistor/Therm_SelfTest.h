@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Therm_LUT.h"
+#include "Therm_Filter.h"
+
+/***********************
+ *  BOOT SELF-TESTS
+ *  On-target counterparts of tools/therm_bench: same checks, timed in CPU
+ *  cycles and reported with ESP_LOG. Enabled by the *_SELFTEST switches in
+ *  Thermistor.h; the conversion and filter code itself stays plain C.
+ ***********************/
+
+/**
+ * Compare the table against the float model for every ADC code over
+ * 0-3.3V and log the worst error and CPU cycles per conversion of both paths.
+ */
+void Therm_LUT_SelfTest(const therm_lut_t *lut, const therm_params_t *p);
+
+/**
+ * Run a synthetic noise trace (slow ramp across a trigger threshold
+ * with jitter and ignition spikes) through the raw path and the filter,
+ * and log threshold-crossing chatter of both plus CPU cycles per sample.
+ */
+void Therm_Filter_SelfTest(const therm_filter_cfg_t *cfg);
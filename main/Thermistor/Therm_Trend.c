@@ -0,0 +1,62 @@
+#include "Therm_Trend.h"
+
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Therm_Trend_Init(therm_trend_t *t, uint16_t window)
+{
+    if (window < 2) window = 2;
+    if (window > THERM_TREND_MAX) window = THERM_TREND_MAX;
+    t->window = window;
+    Therm_Trend_Reset(t);
+}
+
+void Therm_Trend_Reset(therm_trend_t *t)
+{
+    t->count = 0;
+    t->pos = 0;
+    t->sum_y = 0;
+    t->sum_iy = 0;
+}
+
+void Therm_Trend_Push(therm_trend_t *t, int32_t centi_c)
+{
+    if (t->count < t->window) {
+        /* Filling: the new reading takes index count */
+        t->sum_iy += (int64_t)t->count * centi_c;
+        t->sum_y += centi_c;
+        t->buf[t->pos] = centi_c;
+        t->count++;
+    } else {
+        /* Sliding: the oldest leaves, every other index drops by one,
+         * the new reading takes index window - 1 */
+        int32_t old = t->buf[t->pos];
+        t->sum_y -= old;
+        t->sum_iy -= t->sum_y;
+        t->sum_iy += (int64_t)(t->window - 1) * centi_c;
+        t->sum_y += centi_c;
+        t->buf[t->pos] = centi_c;
+    }
+    if (++t->pos >= t->window) t->pos = 0;
+}
+
+bool Therm_Trend_Get(const therm_trend_t *t, uint32_t publish_hz, float *slope_c_per_s, float *fit_now_c)
+{
+    if (t->count < t->window) {
+        return false;
+    }
+
+    /* Index sums are constants of the window length */
+    int64_t n = t->window;
+    int64_t sum_i = n * (n - 1) / 2;
+    int64_t sum_ii = (n - 1) * n * (2 * n - 1) / 6;
+    int64_t denom = n * sum_ii - sum_i * sum_i;
+
+    /* Slope in 0.01 °C per reading, intercept at i = 0 */
+    float b = (float)(n * t->sum_iy - sum_i * t->sum_y) / (float)denom;
+    float a = ((float)t->sum_y - b * (float)sum_i) / (float)n;
+
+    *slope_c_per_s = b * (float)publish_hz / 100.0f;
+    *fit_now_c = (a + b * (float)(n - 1)) / 100.0f;
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/***********************
+ *  TREND ESTIMATOR
+ *  Least-squares line through the last `window` readings (uniformly
+ *  spaced at the publish rate), in 0.01 °C. The sums the fit needs are
+ *  updated as each reading enters and the oldest leaves, so a push is
+ *  O(1) regardless of the window length. Integer sums, no drift.
+ ***********************/
+#define THERM_TREND_MAX     64      // Largest supported window
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+typedef struct {
+    int32_t  buf[THERM_TREND_MAX];  // Window contents, circular
+    uint16_t window;                // Fit length in readings
+    uint16_t count;                 // Readings held (<= window)
+    uint16_t pos;                   // Next write / oldest slot once full
+    int64_t  sum_y;                 // Σ y_i
+    int64_t  sum_iy;                // Σ i * y_i, i = 0 for the oldest reading
+} therm_trend_t;
+
+/***********************
+ *  FUNCTION DECLARATIONS
+ ***********************/
+
+/** Set the window (clamped to 2..THERM_TREND_MAX) and clear the state */
+void Therm_Trend_Init(therm_trend_t *t, uint16_t window);
+
+/** Drop all readings, e.g. after a rejected sample breaks the series */
+void Therm_Trend_Reset(therm_trend_t *t);
+
+/** Add the newest reading (0.01 °C). O(1). */
+void Therm_Trend_Push(therm_trend_t *t, int32_t centi_c);
+
+/**
+ * Evaluate the fit once the window is full.
+ * @param publish_hz   Readings per second
+ * @param slope_c_per_s Filled with dT/dt in °C/s
+ * @param fit_now_c    Filled with the fitted temperature at the newest reading
+ * @return false until `window` readings have been pushed since the last reset
+ */
+bool Therm_Trend_Get(const therm_trend_t *t, uint32_t publish_hz, float *slope_c_per_s, float *fit_now_c);
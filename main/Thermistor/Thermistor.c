@@ -1,100 +1,494 @@
 #include "Thermistor.h"
+#include "Therm_SelfTest.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "Driver_Events.h"
+#include "BAT_Driver.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <math.h>
+#include <string.h>
 
 static const char *THERM_TAG = "Thermistor";
 
-static adc_oneshot_unit_handle_t adc_handle = NULL;
+static adc_continuous_handle_t adc_handle = NULL;          /* ADC1 scan */
+static adc_oneshot_unit_handle_t oneshot_handle = NULL;    /* ADC2 probes */
+static esp_timer_handle_t publish_timer = NULL;
+static TaskHandle_t consumer_task = NULL;
 
-/* GPIO19 = ADC2_CH8 on ESP32-S3 */
-#define THERMISTOR_ADC_UNIT     ADC_UNIT_2
-#define THERMISTOR_ADC_CHANNEL  ADC_CHANNEL_8
 #define THERMISTOR_ADC_ATTEN    ADC_ATTEN_DB_12    /* Full 0-3.3V range */
+#define THERMISTOR_ADC_CHANNELS 10                 /* Channels per ADC unit on ESP32-S3 */
 
-void Thermistor_Init(void)
+#define THERMISTOR_SCAN_SLOTS   (THERM_CH_COUNT + BAT_MONITOR_ENABLED)   /* Largest scan pattern */
+#define THERMISTOR_FRAME_BYTES  (THERMISTOR_FRAME_SAMPLES * THERMISTOR_SCAN_SLOTS * SOC_ADC_DIGI_RESULT_BYTES)
+#define CHANNEL_SUPPLY          THERM_CH_COUNT     /* channel_map index of the battery monitor */
+
+/* Consumer task wake-up reasons (task notification bits) */
+#define NOTIFY_FRAME            (1u << 0)          /* DMA frame ready */
+#define NOTIFY_PUBLISH          (1u << 1)          /* Publish timer tick */
+
+_Static_assert(THERM_CH_COUNT <= SENSOR_MAX_CHANNELS, "sensor_sample_t cannot hold every thermistor channel");
+#if BAT_MONITOR_ENABLED && THERM_AMBIENT_ENABLED && THERM_AMBIENT_GPIO == BAT_GPIO
+#error "THERM_AMBIENT and the battery monitor share GPIO4: disable one of them"
+#endif
+
+/***********************
+ *  CHANNEL TABLE
+ *  Order must match therm_channel_id_t.
+ ***********************/
+typedef struct {
+    const char     *name;
+    bool            enabled;
+    int             gpio;
+    adc_unit_t      unit;
+    adc_channel_t   channel;
+    therm_params_t  params;
+} therm_channel_cfg_t;
+
+#define THERM_DEFAULT_PARAMS {                  \
+        .model = THERMISTOR_MODEL,              \
+        .series_r = THERMISTOR_SERIES_R,        \
+        .nominal_r = THERMISTOR_NOMINAL_R,      \
+        .nominal_t = THERMISTOR_NOMINAL_T,      \
+        .beta = THERMISTOR_BETA,                \
+        .sh_a = THERMISTOR_SH_A,                \
+        .sh_b = THERMISTOR_SH_B,                \
+        .sh_c = THERMISTOR_SH_C,                \
+    }
+
+static const therm_channel_cfg_t channel_cfg[THERM_CH_COUNT] = {
+    [THERM_CH_INLET] = {
+        .name = "inlet",
+        .enabled = THERM_INLET_ENABLED,
+        .gpio = THERM_INLET_GPIO,
+        .unit = THERM_INLET_ADC_UNIT,
+        .channel = THERM_INLET_ADC_CHANNEL,
+        .params = THERM_DEFAULT_PARAMS,
+    },
+    [THERM_CH_OUTLET] = {
+        .name = "outlet",
+        .enabled = THERM_OUTLET_ENABLED,
+        .gpio = THERM_OUTLET_GPIO,
+        .unit = THERM_OUTLET_ADC_UNIT,
+        .channel = THERM_OUTLET_ADC_CHANNEL,
+        .params = THERM_DEFAULT_PARAMS,
+    },
+    [THERM_CH_AMBIENT] = {
+        .name = "ambient",
+        .enabled = THERM_AMBIENT_ENABLED,
+        .gpio = THERM_AMBIENT_GPIO,
+        .unit = THERM_AMBIENT_ADC_UNIT,
+        .channel = THERM_AMBIENT_ADC_CHANNEL,
+        .params = THERM_DEFAULT_PARAMS,
+    },
+};
+
+/* (unit, channel) of a DMA result -> table index, CHANNEL_SUPPLY, or -1 if not scanned */
+static int8_t channel_map[2][THERMISTOR_ADC_CHANNELS];
+
+/* ADC2 channels, read by oneshot bursts instead of the scan */
+static int8_t oneshot_ch[THERM_CH_COUNT];
+static int oneshot_num = 0;
+
+/* Enabled channels whose ADC unit actually started. The two units are set
+ * up independently, so one failing does not take the other's channels down */
+static bool channel_live[THERM_CH_COUNT];
+
+/***********************
+ *  CONVERSION
+ *  ADC code -> temperature goes through a table built once at init per
+ *  channel, so the consumer task does no float divide or logf per reading.
+ *  Each valid reading is then filtered (Therm_Filter.h).
+ ***********************/
+static therm_lut_t therm_lut[THERM_CH_COUNT];
+static therm_filter_t therm_filter[THERM_CH_COUNT];
+static therm_trend_t therm_trend[THERM_CH_COUNT];
+
+static const therm_filter_cfg_t filter_cfg = {
+    .median_len = THERMISTOR_FILTER_MEDIAN,
+    .alpha_q15 = (uint16_t)(THERMISTOR_FILTER_ALPHA * THERM_FILTER_ALPHA_ONE),
+    .slew_centi_c = (int32_t)(THERMISTOR_FILTER_SLEW_C_PER_S * 100.0f / THERMISTOR_PUBLISH_HZ),
+};
+
+static sensor_health_state_t therm_health[THERM_CH_COUNT];
+
+/** Log health transitions once, instead of repeating a warning every reading */
+static void log_health_change(int ch, uint32_t flags)
 {
-    ESP_LOGI(THERM_TAG, "Initializing thermistor on GPIO%d...", THERMISTOR_GPIO);
+    static sensor_health_t last[THERM_CH_COUNT];
+    sensor_health_t health = Sensor_Health_FromFlags(flags);
+    if (health == last[ch]) return;
 
+    if (health == SENSOR_HEALTH_FAULT) {
+        ESP_LOGW(THERM_TAG, "%s probe FAULT: %s", channel_cfg[ch].name, Sensor_Health_Reason(flags));
+    } else if (health == SENSOR_HEALTH_OK && last[ch] == SENSOR_HEALTH_FAULT) {
+        ESP_LOGI(THERM_TAG, "%s probe recovered", channel_cfg[ch].name);
+    }
+    last[ch] = health;
+}
+
+static void code_to_sample(int ch, uint32_t code_q8, sensor_sample_t *out)
+{
+    int16_t centi_c = Therm_LUT_Lookup(&therm_lut[ch], code_q8);
+    bool in_range = centi_c != THERM_LUT_INVALID;
+
+    /* Every plausible reading goes through the filter, so its median sees
+     * (and removes) ignition spikes; the rate check then judges the median
+     * output, i.e. only jumps that persist for half the window */
+    bool plausible = Sensor_Health_Plausible(out->raw_mv[ch], in_range);
+    int32_t filtered = 0;
+    if (plausible) {
+        filtered = Therm_Filter_Step(&therm_filter[ch], centi_c);
+    }
+    uint32_t flags = Sensor_Health_Check(&therm_health[ch], out->raw_mv[ch], code_q8,
+                                         therm_filter[ch].median, plausible, THERMISTOR_PUBLISH_HZ);
+    out->flags[ch] = flags;
+    log_health_change(ch, flags);
+
+    if (flags & SENSOR_FLAG_VALID) {
+        out->temp_c[ch] = filtered / 100.0f;
+
+        float rate, fit_now;
+        Therm_Trend_Push(&therm_trend[ch], filtered);
+        if (Therm_Trend_Get(&therm_trend[ch], THERMISTOR_PUBLISH_HZ, &rate, &fit_now)) {
+            out->rate_c_per_s[ch] = rate;
+            out->forecast_c[ch] = fit_now + rate * THERMISTOR_FORECAST_S;
+            out->flags[ch] |= SENSOR_FLAG_TREND;
+        }
+        return;
+    }
+
+    /* Rejected readings never reach the fit. Start the filter afresh once a
+     * confirmed fault clears, rather than slewing from the last good value.
+     * An unconfirmed rate flag only skips this reading; an electrical
+     * problem or a latched fault restarts the fit. */
+    if (flags & SENSOR_FLAG_FAULT) {
+        Therm_Filter_Reset(&therm_filter[ch]);
+    }
+    if (flags & (SENSOR_FLAG_FAULT | (SENSOR_FLAG_BAD_MASK & ~SENSOR_FLAG_RATE))) {
+        Therm_Trend_Reset(&therm_trend[ch]);
+    }
+    out->temp_c[ch] = in_range ? centi_c / 100.0f : NAN;
+}
+
+/***********************
+ *  SAMPLING PIPELINE
+ *  ADC1 channels come from the DMA scan; ADC2 channels are read in a
+ *  oneshot burst on every publish tick, since the ESP32-S3 cannot run ADC2
+ *  in continuous mode (errata). Both feed the same per-channel sums.
+ ***********************/
+static bool IRAM_ATTR conv_done_cb(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    BaseType_t wake = pdFALSE;
+    xTaskNotifyFromISR(consumer_task, NOTIFY_FRAME, eSetBits, &wake);
+    return wake == pdTRUE;
+}
+
+static void publish_timer_cb(void *arg)
+{
+    xTaskNotify(consumer_task, NOTIFY_PUBLISH, eSetBits);
+}
+
+/** Average one oversampled block of every channel and push it into the sensor ring */
+static void publish(const uint32_t *sum_raw, const uint32_t *count)
+{
+    sensor_sample_t sample = {
+        .timestamp_us = esp_timer_get_time(),
+        .supply_mv = BAT_Get_Supply_mV(),
+    };
+
+    for (int ch = 0; ch < THERM_CH_COUNT; ch++) {
+        if (count[ch] == 0) {
+            sample.raw_mv[ch] = -1;
+            sample.temp_c[ch] = NAN;
+            continue;   /* Disabled channel: flags stay 0 */
+        }
+        /* 12-bit ADC, 3.3V range with DB_12 attenuation */
+        uint32_t code_q8 = (sum_raw[ch] << THERM_LUT_FRAC_BITS) / count[ch];
+        sample.raw_mv[ch] = (int32_t)((code_q8 * 3300u) / (4095u << THERM_LUT_FRAC_BITS));
+        code_to_sample(ch, code_q8, &sample);
+    }
+
+    Sensor_Ring_Push(&sample);
+    Driver_Events_Post(DRIVER_EVT_SENSOR);
+}
+
+/** Drain every frame the driver has buffered since the last wake-up */
+static void drain_scan(uint8_t *frame, uint32_t frame_len, uint32_t *sum_raw, uint32_t *count)
+{
+    static uint32_t supply_sum = 0;
+    static uint32_t supply_count = 0;
+    uint32_t len = 0;
+
+    while (adc_continuous_read(adc_handle, frame, frame_len, &len, 0) == ESP_OK) {
+        for (uint32_t i = 0; i < len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&frame[i];
+            if (p->type2.channel >= THERMISTOR_ADC_CHANNELS) continue;
+            int ch = channel_map[p->type2.unit][p->type2.channel];
+            if (ch < 0) continue;
+
+            if (ch == CHANNEL_SUPPLY) {
+                supply_sum += p->type2.data;
+                if (++supply_count >= BAT_FEED_SCANS) {
+                    BAT_Feed(supply_sum, supply_count);
+                    supply_sum = 0;
+                    supply_count = 0;
+                }
+                continue;
+            }
+            sum_raw[ch] += p->type2.data;
+            count[ch]++;
+        }
+    }
+}
+
+/** Read every ADC2 channel THERMISTOR_ONESHOT_READS times, interleaved */
+static void read_oneshot(uint32_t *sum_raw, uint32_t *count)
+{
+    for (int n = 0; n < THERMISTOR_ONESHOT_READS; n++) {
+        for (int i = 0; i < oneshot_num; i++) {
+            int ch = oneshot_ch[i];
+            int raw;
+            /* Fails with ESP_ERR_TIMEOUT while Wi-Fi holds ADC2: skip the read */
+            if (adc_oneshot_read(oneshot_handle, channel_cfg[ch].channel, &raw) == ESP_OK) {
+                sum_raw[ch] += (uint32_t)raw;
+                count[ch]++;
+            }
+        }
+    }
+}
+
+static void consumer_task_fn(void *arg)
+{
+    static uint8_t frame[THERMISTOR_FRAME_BYTES];
+    uint32_t sum_raw[THERM_CH_COUNT] = { 0 };
+    uint32_t count[THERM_CH_COUNT] = { 0 };
+
+    while (1) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+
+        if ((bits & NOTIFY_FRAME) && adc_handle) {
+            drain_scan(frame, sizeof(frame), sum_raw, count);
+        }
+        if (!(bits & NOTIFY_PUBLISH)) continue;
+
+        read_oneshot(sum_raw, count);
+
+        /* An ADC2 channel that got no read at all keeps accumulating into
+         * the next tick rather than publishing as if it were disabled */
+        bool ready = true;
+        for (int i = 0; i < oneshot_num; i++) {
+            if (count[oneshot_ch[i]] == 0) ready = false;
+        }
+        if (!ready) continue;
+
+        publish(sum_raw, count);
+        memset(sum_raw, 0, sizeof(sum_raw));
+        memset(count, 0, sizeof(count));
+    }
+}
+
+/***********************
+ *  ADC SETUP
+ ***********************/
+static esp_err_t oneshot_start(void)
+{
     adc_oneshot_unit_init_cfg_t unit_cfg = {
-        .unit_id = THERMISTOR_ADC_UNIT,
+        .unit_id = ADC_UNIT_2,
     };
-    esp_err_t ret = adc_oneshot_new_unit(&unit_cfg, &adc_handle);
+    esp_err_t ret = adc_oneshot_new_unit(&unit_cfg, &oneshot_handle);
     if (ret != ESP_OK) {
         ESP_LOGE(THERM_TAG, "adc_oneshot_new_unit failed: %s", esp_err_to_name(ret));
-        return;
+        return ret;
     }
 
     adc_oneshot_chan_cfg_t chan_cfg = {
         .atten = THERMISTOR_ADC_ATTEN,
         .bitwidth = ADC_BITWIDTH_DEFAULT,
     };
-    ret = adc_oneshot_config_channel(adc_handle, THERMISTOR_ADC_CHANNEL, &chan_cfg);
-    if (ret != ESP_OK) {
-        ESP_LOGE(THERM_TAG, "adc_oneshot_config_channel failed: %s", esp_err_to_name(ret));
-        return;
+    for (int i = 0; i < oneshot_num; i++) {
+        ret = adc_oneshot_config_channel(oneshot_handle, channel_cfg[oneshot_ch[i]].channel, &chan_cfg);
+        if (ret != ESP_OK) {
+            ESP_LOGE(THERM_TAG, "adc_oneshot_config_channel failed: %s", esp_err_to_name(ret));
+            adc_oneshot_del_unit(oneshot_handle);
+            oneshot_handle = NULL;
+            return ret;
+        }
     }
-
-    ESP_LOGI(THERM_TAG, "Thermistor initialized on GPIO%d (ADC1_CH%d)", THERMISTOR_GPIO, THERMISTOR_ADC_CHANNEL);
+    return ESP_OK;
 }
 
-int Thermistor_ReadRawMV(void)
+/** Configure and start the ADC1 scan; on failure the handle is released */
+static esp_err_t scan_start(adc_digi_pattern_config_t *pattern, uint32_t pattern_num)
 {
-    if (!adc_handle) return -1;
-
-    int raw = 0;
-    esp_err_t ret = adc_oneshot_read(adc_handle, THERMISTOR_ADC_CHANNEL, &raw);
+    adc_continuous_handle_t handle = NULL;
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = THERMISTOR_FRAME_BYTES * 4,
+        .conv_frame_size = THERMISTOR_FRAME_SAMPLES * pattern_num * SOC_ADC_DIGI_RESULT_BYTES,
+    };
+    esp_err_t ret = adc_continuous_new_handle(&handle_cfg, &handle);
     if (ret != ESP_OK) {
-        ESP_LOGW(THERM_TAG, "ADC read failed: %s", esp_err_to_name(ret));
-        return -1;
+        ESP_LOGE(THERM_TAG, "adc_continuous_new_handle failed: %s", esp_err_to_name(ret));
+        return ret;
     }
 
-    /* 12-bit ADC, 3.3V range with DB_12 attenuation */
-    int voltage_mv = (raw * 3300) / 4095;
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = pattern_num,
+        .adc_pattern = pattern,
+        .sample_freq_hz = THERMISTOR_SAMPLE_RATE_HZ * pattern_num,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+    adc_continuous_evt_cbs_t cbs = {
+        .on_conv_done = conv_done_cb,
+    };
+    ret = adc_continuous_config(handle, &dig_cfg);
+    if (ret == ESP_OK) ret = adc_continuous_register_event_callbacks(handle, &cbs, NULL);
+    if (ret == ESP_OK) {
+        adc_handle = handle;    /* Set before start: the first frame may arrive at once */
+        ret = adc_continuous_start(handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(THERM_TAG, "ADC1 scan failed to start: %s", esp_err_to_name(ret));
+        adc_handle = NULL;
+        adc_continuous_deinit(handle);
+    }
+    return ret;
+}
 
-    return voltage_mv;
+/** Stop publishing the channels of an ADC unit that failed to start */
+static void drop_unit(adc_unit_t unit)
+{
+    for (int ch = 0; ch < THERM_CH_COUNT; ch++) {
+        if (channel_live[ch] && channel_cfg[ch].unit == unit) {
+            channel_live[ch] = false;
+            ESP_LOGE(THERM_TAG, "Channel %s disabled: ADC%d unavailable", channel_cfg[ch].name, unit + 1);
+        }
+    }
 }
 
-float Thermistor_ReadTemp(void)
+/***********************
+ *  PUBLIC FUNCTIONS
+ ***********************/
+void Thermistor_Init(void)
 {
-    /* Average multiple readings for stability */
-    int sum_mv = 0;
-    int valid_readings = 0;
-    for (int i = 0; i < 8; i++) {
-        int mv = Thermistor_ReadRawMV();
-        if (mv >= 0) {
-            sum_mv += mv;
-            valid_readings++;
+    adc_digi_pattern_config_t pattern[THERMISTOR_SCAN_SLOTS];
+    uint32_t pattern_num = 0;
+    int enabled_num = 0;
+
+    memset(channel_map, -1, sizeof(channel_map));
+
+    for (int ch = 0; ch < THERM_CH_COUNT; ch++) {
+        const therm_channel_cfg_t *cfg = &channel_cfg[ch];
+        if (!cfg->enabled) continue;
+
+        Therm_LUT_Build(&therm_lut[ch], &cfg->params);
+#if THERMISTOR_LUT_SELFTEST
+        Therm_LUT_SelfTest(&therm_lut[ch], &cfg->params);
+#endif
+        Therm_Filter_Init(&therm_filter[ch], &filter_cfg);
+        Sensor_Health_Init(&therm_health[ch]);
+        Therm_Trend_Init(&therm_trend[ch], THERMISTOR_TREND_WINDOW);
+        channel_live[ch] = true;
+        enabled_num++;
+
+        if (cfg->unit == ADC_UNIT_2) {
+            oneshot_ch[oneshot_num++] = (int8_t)ch;
+        } else {
+            pattern[pattern_num++] = (adc_digi_pattern_config_t) {
+                .atten = THERMISTOR_ADC_ATTEN,
+                .channel = cfg->channel,
+                .unit = cfg->unit,
+                .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+            };
+            channel_map[cfg->unit][cfg->channel] = (int8_t)ch;
         }
+
+        ESP_LOGI(THERM_TAG, "Channel %s on GPIO%d (ADC%d_CH%d, %s)", cfg->name, cfg->gpio,
+                 cfg->unit + 1, cfg->channel, cfg->unit == ADC_UNIT_2 ? "oneshot" : "scan");
+    }
+    if (enabled_num == 0) {
+        ESP_LOGE(THERM_TAG, "No thermistor channel enabled");
+#if BAT_MONITOR_ENABLED
+        BAT_Start_Oneshot();
+#endif
+        return;
     }
+#if BAT_MONITOR_ENABLED
+    /* Battery monitor rides along at the end of the scan (BAT_Driver.h) */
+    _Static_assert(BAT_ADC_UNIT == ADC_UNIT_1, "the battery monitor must be on ADC1 to be scanned");
+    pattern[pattern_num++] = (adc_digi_pattern_config_t) {
+        .atten = EXAMPLE_ADC_ATTEN,
+        .channel = BAT_ADC_CHANNEL,
+        .unit = BAT_ADC_UNIT,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    channel_map[BAT_ADC_UNIT][BAT_ADC_CHANNEL] = CHANNEL_SUPPLY;
+    ESP_LOGI(THERM_TAG, "Supply monitor on GPIO%d (ADC%d_CH%d)", BAT_GPIO, BAT_ADC_UNIT + 1, BAT_ADC_CHANNEL);
+#endif
+#if THERMISTOR_FILTER_SELFTEST
+    Therm_Filter_SelfTest(&filter_cfg);
+#endif
 
-    if (valid_readings == 0) {
-        return -999.0f;
+    if (oneshot_num > 0 && oneshot_start() != ESP_OK) {
+        drop_unit(ADC_UNIT_2);
+        oneshot_num = 0;
     }
 
-    float voltage_mv = (float)sum_mv / valid_readings;
-    float voltage_v = voltage_mv / 1000.0f;
+    xTaskCreatePinnedToCore(consumer_task_fn, "therm_adc", 3072, NULL, 4, &consumer_task, 0);
 
-    /* Voltage divider: 3.3V --- [R_series] --- ADC --- [NTC] --- GND
-     * V_adc = 3.3 * R_ntc / (R_series + R_ntc)
-     * R_ntc = R_series * V_adc / (3.3 - V_adc) */
-    if (voltage_v <= 0.01f || voltage_v >= 3.29f) {
-        static int oor_count = 0;
-        if (++oor_count >= 20) {  // Only warn every ~2 seconds
-            ESP_LOGW(THERM_TAG, "Thermistor voltage out of range: %.0f mV (disconnected?)", voltage_mv);
-            oor_count = 0;
-        }
-        return -999.0f;
+    if (pattern_num > 0 && scan_start(pattern, pattern_num) != ESP_OK) {
+        drop_unit(ADC_UNIT_1);
+#if BAT_MONITOR_ENABLED
+        BAT_Start_Oneshot();    /* The supply must still be watched for brown-outs */
+#endif
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = publish_timer_cb,
+        .name = "therm_publish",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &publish_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(publish_timer, 1000000 / THERMISTOR_PUBLISH_HZ));
+
+    ESP_LOGI(THERM_TAG, "Thermistor initialized: %d channel(s), %d by oneshot, scan %s, %d Hz",
+             enabled_num, oneshot_num, adc_handle ? "running" : "off", THERMISTOR_PUBLISH_HZ);
+}
+
+sensor_health_t Thermistor_ReadChannel(therm_channel_id_t ch, float *temp_c)
+{
+    sensor_sample_t s;
+    if (ch >= THERM_CH_COUNT || !Sensor_Ring_Latest(&s)) {
+        if (temp_c) *temp_c = NAN;
+        return SENSOR_HEALTH_DISABLED;
+    }
+    if (temp_c) *temp_c = s.temp_c[ch];
+    return Sensor_Health_FromFlags(s.flags[ch]);
+}
+
+int Thermistor_ReadChannelRawMV(therm_channel_id_t ch)
+{
+    sensor_sample_t s;
+    if (ch >= THERM_CH_COUNT || !channel_live[ch] || !Sensor_Ring_Latest(&s)) {
+        return -1;
     }
+    return (int)s.raw_mv[ch];
+}
 
-    float r_ntc = THERMISTOR_SERIES_R * voltage_v / (3.3f - voltage_v);
+sensor_health_t Thermistor_ReadTemp(float *temp_c)
+{
+    return Thermistor_ReadChannel(THERMISTOR_CONTROL_CHANNEL, temp_c);
+}
 
-    /* Steinhart-Hart simplified (Beta equation):
-     * 1/T = 1/T0 + (1/B) * ln(R/R0)
-     * T in Kelvin */
-    float steinhart = logf(r_ntc / THERMISTOR_NOMINAL_R) / THERMISTOR_BETA;
-    steinhart += 1.0f / (THERMISTOR_NOMINAL_T + 273.15f);
-    float temp_c = (1.0f / steinhart) - 273.15f;
+bool Thermistor_ChannelEnabled(therm_channel_id_t ch)
+{
+    return ch < THERM_CH_COUNT && channel_live[ch];
+}
 
-    return temp_c;
+const char *Thermistor_ChannelName(therm_channel_id_t ch)
+{
+    return ch < THERM_CH_COUNT ? channel_cfg[ch].name : "?";
 }
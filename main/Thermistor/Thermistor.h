@@ -1,39 +1,158 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "hal/adc_types.h"
+#include "Therm_LUT.h"
+#include "Therm_Filter.h"
+#include "Therm_Trend.h"
+#include "Sensor_Ring.h"
+#include "Sensor_Health.h"
 
 /***********************
- *  PIN CONFIGURATION
+ *  CHANNEL CONFIGURATION
+ *  One NTC per channel:
+ *    INLET   — charge air before the intercooler (hot side)
+ *    OUTLET  — charge air after the intercooler (control probe)
+ *    AMBIENT — outside air
+ *  Only ADC-capable pins (ADC1: GPIO1-10, ADC2: GPIO11-20) can be used.
+ *  On this board GPIO19/20 are the only free ones, so AMBIENT ships
+ *  disabled; set THERM_AMBIENT_ENABLED and its unit/channel once a pin is
+ *  freed (e.g. by disabling the battery monitor on GPIO4 = ADC1_CH3,
+ *  BAT_MONITOR_ENABLED in BAT_Driver.h). ADC1 channels are scanned
+ *  in continuous mode together with the battery monitor; ADC2 channels
+ *  are read with oneshot conversions (see SAMPLING CONFIGURATION). The
+ *  two units start independently: if one fails, its channels read as
+ *  disabled and the other unit keeps publishing.
  ***********************/
-#define THERMISTOR_GPIO         19      // GPIO19 = ADC2_CH8
+#define THERM_INLET_ENABLED     1
+#define THERM_INLET_GPIO        20                  // GPIO20 = ADC2_CH9 (oneshot)
+#define THERM_INLET_ADC_UNIT    ADC_UNIT_2
+#define THERM_INLET_ADC_CHANNEL ADC_CHANNEL_9
+
+#define THERM_OUTLET_ENABLED     1
+#define THERM_OUTLET_GPIO        19                 // GPIO19 = ADC2_CH8 (oneshot)
+#define THERM_OUTLET_ADC_UNIT    ADC_UNIT_2
+#define THERM_OUTLET_ADC_CHANNEL ADC_CHANNEL_8
+
+#define THERM_AMBIENT_ENABLED     0
+#define THERM_AMBIENT_GPIO        4                 // GPIO4 = ADC1_CH3 (battery monitor by default)
+#define THERM_AMBIENT_ADC_UNIT    ADC_UNIT_1
+#define THERM_AMBIENT_ADC_CHANNEL ADC_CHANNEL_3
+
+/* Probe used by absolute-temperature control, the UI and the legacy readers */
+#define THERMISTOR_CONTROL_CHANNEL  THERM_CH_OUTLET
+#define THERMISTOR_GPIO             THERM_OUTLET_GPIO
 
 /***********************
  *  THERMISTOR PARAMETERS
- *  100K NTC with B=3950
+ *  Default probe: 100K NTC with B=3950
  *  Using voltage divider: 3.3V --- [100K fixed] --- ADC_PIN --- [NTC] --- GND
+ *  Each channel has its own copy in the channel table (Thermistor.c),
+ *  so mixed probes or divider values only need a table edit.
  ***********************/
 #define THERMISTOR_NOMINAL_R    100000.0f   // Resistance at 25°C (ohms)
 #define THERMISTOR_NOMINAL_T    25.0f       // Nominal temperature (°C)
 #define THERMISTOR_BETA         3950.0f     // Beta coefficient
 #define THERMISTOR_SERIES_R     100000.0f   // Series resistor value (ohms)
 
+/* Conversion model used to build the ADC-code -> temperature table.
+ * THERM_MODEL_BETA uses the values above; THERM_MODEL_STEINHART_HART
+ * uses the A/B/C coefficients below (generic 100K/3950 values — replace
+ * with datasheet or calibration coefficients for a specific probe). */
+#define THERMISTOR_MODEL        THERM_MODEL_BETA
+#define THERMISTOR_SH_A         0.000722378f
+#define THERMISTOR_SH_B         0.000216302f
+#define THERMISTOR_SH_C         9.26410e-08f
+
+/* Set to 1 to compare the lookup table against the float model at boot
+ * and log the worst error and cycles per conversion */
+#define THERMISTOR_LUT_SELFTEST 0
+
+/***********************
+ *  SAMPLING CONFIGURATION
+ *  ADC1 channels free-run in continuous (DMA) mode over one scan pattern.
+ *  The ESP32-S3 cannot use ADC2 in continuous mode (errata; ESP-IDF only
+ *  allows it with CONFIG_ADC_CONTINUOUS_FORCE_USE_ADC2_ON_C3_S3), so ADC2
+ *  channels are read with THERMISTOR_ONESHOT_READS oneshot conversions
+ *  each on every publish tick. A consumer task averages everything
+ *  gathered since the last tick into one multi-channel sample and pushes
+ *  it into the sensor ring (Sensor_Ring.h), which every consumer reads
+ *  lock-free. ADC2 reads fail while Wi-Fi is active; such a tick is
+ *  skipped until a read succeeds.
+ ***********************/
+#define THERMISTOR_PUBLISH_HZ       10      // Published readings per second (timer tick)
+#define THERMISTOR_SAMPLE_RATE_HZ   2000    // ADC1 scans per second, per channel (1–10 kHz total)
+#define THERMISTOR_FRAME_SAMPLES    100     // Scans per DMA frame (one task wake-up)
+#define THERMISTOR_ONESHOT_READS    64      // ADC2 conversions per channel per reading
+
+/***********************
+ *  FILTER CONFIGURATION
+ *  Every channel runs its readings through Therm_Filter (median -> IIR ->
+ *  slew limit) before they reach the sensor ring. The defaults reject
+ *  ignition spikes up to 2 readings long and add ~0.3 s of lag.
+ ***********************/
+#define THERMISTOR_FILTER_MEDIAN        5       // Median window in readings (1 = off)
+#define THERMISTOR_FILTER_ALPHA         0.3f    // IIR weight of each new reading (1.0 = off)
+#define THERMISTOR_FILTER_SLEW_C_PER_S  10.0f   // Max rate of change in °C/s (0 = off)
+
+/* Set to 1 to run the filter on a synthetic noisy trace at boot and log
+ * threshold chatter (raw vs filtered) and cycles per reading. On the host,
+ * tools/therm_bench runs recorded traces through filter + health checks */
+#define THERMISTOR_FILTER_SELFTEST      0
+
+/***********************
+ *  TREND / FORECAST
+ *  A least-squares line through the last THERMISTOR_TREND_WINDOW filtered
+ *  readings gives each channel's dT/dt and a forecast THERMISTOR_FORECAST_S
+ *  ahead, published with the sample (SENSOR_FLAG_TREND). The spray engine
+ *  can trigger on the forecast instead of waiting for heat soak.
+ ***********************/
+#define THERMISTOR_TREND_WINDOW     30      // Readings in the fit (3 s)
+#define THERMISTOR_FORECAST_S       5.0f    // Forecast horizon in seconds
+
+/***********************
+ *  TYPE DEFINITIONS
+ ***********************/
+
+/** Channel index, also the index into sensor_sample_t arrays */
+typedef enum {
+    THERM_CH_INLET,
+    THERM_CH_OUTLET,
+    THERM_CH_AMBIENT,
+    THERM_CH_COUNT,
+} therm_channel_id_t;
+
 /***********************
  *  FUNCTION DECLARATIONS
  ***********************/
 
 /**
- * Initialize the thermistor ADC input
+ * Initialize the ADC1 scan and the ADC2 oneshot unit for every enabled
+ * channel and start the consumer task that averages them into sensor ring
+ * samples at THERMISTOR_PUBLISH_HZ
  */
 void Thermistor_Init(void);
 
 /**
- * Read the current temperature in Celsius
- * @return Temperature in °C, or -999.0f on error
+ * Latest reading of one channel. O(1), never touches the ADC.
+ * @param temp_c Filled with the temperature in °C (filtered when the result
+ *               is SENSOR_HEALTH_OK, NAN if there is none); may be NULL
+ * @return Channel health; only SENSOR_HEALTH_OK readings are fit for control
  */
-float Thermistor_ReadTemp(void);
+sensor_health_t Thermistor_ReadChannel(therm_channel_id_t ch, float *temp_c);
 
 /**
- * Read raw ADC voltage in millivolts (for debugging)
- * @return Voltage in mV
+ * Latest averaged ADC voltage of one channel in millivolts (for debugging). O(1).
+ * @return Voltage in mV, or -1 if disabled / no reading yet
  */
-int Thermistor_ReadRawMV(void);
+int Thermistor_ReadChannelRawMV(therm_channel_id_t ch);
+
+/** Reading of THERMISTOR_CONTROL_CHANNEL, see Thermistor_ReadChannel() */
+sensor_health_t Thermistor_ReadTemp(float *temp_c);
+
+/** @return true if the channel is sampled */
+bool Thermistor_ChannelEnabled(therm_channel_id_t ch);
+
+/** @return Short channel name for logs ("inlet", "outlet", "ambient") */
+const char *Thermistor_ChannelName(therm_channel_id_t ch);
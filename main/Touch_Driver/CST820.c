@@ -1,4 +1,6 @@
 #include "CST820.h"
+#include <stdatomic.h>
+#include "esp_timer.h"
 
 #define POINT_NUM_MAX       (1)
 
@@ -7,8 +9,16 @@
 #define TOUCH_NUM           (0x02)
 #define TOUCH_POSITION      (0x03)
 
+#define DIS_AUTO_SLEEP_REG  (0xFE)
+
 static const char *TAG = "cst820";
 
+static volatile cst820_read_mode_t s_read_mode = CST820_READ_MODE;
+static int s_burst_failures = 0;
+static uint8_t s_report_txns = 0;              /* I2C transactions in the report being read */
+static cst820_timing_t s_timing;
+static portMUX_TYPE s_timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
 
 static esp_err_t read_data(esp_lcd_touch_handle_t tp);
 static bool get_xy(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num);
@@ -82,22 +92,59 @@ err:
     return ret;
 }
 
-static esp_err_t read_data(esp_lcd_touch_handle_t tp)
+/* Fill the point list from 6-byte records (XH, XL, YH, YL, -, -) */
+static void set_points(esp_lcd_touch_handle_t tp, const uint8_t *buf, uint8_t touch_cnt)
+{
+    taskENTER_CRITICAL(&tp->data.lock);
+
+    /* Number of touched points */
+    if(touch_cnt > CONFIG_ESP_LCD_TOUCH_MAX_POINTS)
+        touch_cnt = CONFIG_ESP_LCD_TOUCH_MAX_POINTS;
+
+    uint8_t valid_cnt = 0;
+    /* Fill all coordinates, filtering invalid ones */
+    for (size_t i = 0; i < touch_cnt; i++) {
+        uint16_t raw_x = (uint16_t)(((uint16_t)(buf[(i * 6) ] & 0x0F) << 8) + (buf[(i * 6) + 1]));               
+        uint16_t raw_y = (uint16_t)(((uint16_t)(buf[(i * 6) + 2] & 0x0F) << 8) + (buf[(i * 6) + 3]));
+        
+        /* Check event type - upper nibble of first byte: 0=down, 1=up, 2=contact */
+        uint8_t event = (buf[(i * 6)] >> 4) & 0x0F;
+        
+        /* Discard if coordinates out of range or event is "up" (lift-off) */
+        if (raw_x >= tp->config.x_max || raw_y >= tp->config.y_max || event == 1) {
+            continue;
+        }
+        
+        tp->data.coords[valid_cnt].x = raw_x;
+        tp->data.coords[valid_cnt].y = raw_y;
+        tp->data.coords[valid_cnt].strength = 50;
+        valid_cnt++;
+    }
+    tp->data.points = valid_cnt;
+
+    taskEXIT_CRITICAL(&tp->data.lock);
+}
+
+static void clear_points(esp_lcd_touch_handle_t tp)
+{
+    taskENTER_CRITICAL(&tp->data.lock);
+    tp->data.points = 0;
+    taskEXIT_CRITICAL(&tp->data.lock);
+}
+
+/* Original vendor sequence: up to seven transactions per report */
+static esp_err_t read_data_legacy(esp_lcd_touch_handle_t tp)
 {
     esp_err_t err;
     uint8_t buf[41];
     uint8_t touch_cnt = 0;
     uint8_t clear = 0;
     uint8_t Over = 0xAB;
-    size_t i = 0;
     uint8_t close = 1;
 
-    assert(tp != NULL);
-
-    uint8_t write_buf = 0x01;
-    I2C_Write(ESP_LCD_TOUCH_IO_I2C_CST820_ADDRESS, write_buf, NULL, 0);
+    touch_cst820_i2c_write(tp, 0x01, NULL, 0);
 
-    touch_cst820_i2c_write(tp, 0xFE, &close, 1);
+    touch_cst820_i2c_write(tp, DIS_AUTO_SLEEP_REG, &close, 1);
 
     err = i2c_read_bytes(tp, TOUCH_NUM, buf, 1);
     ESP_RETURN_ON_ERROR(err, TAG, "I2C read error!");
@@ -105,17 +152,13 @@ static esp_err_t read_data(esp_lcd_touch_handle_t tp)
 
     if ((buf[0] & 0x0F) == 0x00) {
         /* No touch - clear points */
-        taskENTER_CRITICAL(&tp->data.lock);
-        tp->data.points = 0;
-        taskEXIT_CRITICAL(&tp->data.lock);
+        clear_points(tp);
         touch_cst820_i2c_write(tp, TOUCH_NUM, &clear, 1);  
     } else {
         /* Count of touched points */
         touch_cnt = buf[0] & 0x0F;
         if (touch_cnt > 2 || touch_cnt == 0) {
-            taskENTER_CRITICAL(&tp->data.lock);
-            tp->data.points = 0;
-            taskEXIT_CRITICAL(&tp->data.lock);
+            clear_points(tp);
             touch_cst820_i2c_write(tp, TOUCH_NUM, &clear, 1);
             return ESP_OK;
         }
@@ -126,41 +169,81 @@ static esp_err_t read_data(esp_lcd_touch_handle_t tp)
         touch_cst820_i2c_write(tp, TOUCH_POSITION, &Over, 1);
 
         /* Clear all */
-        err = touch_cst820_i2c_write(tp, TOUCH_NUM, &clear, 1);
-
-        taskENTER_CRITICAL(&tp->data.lock);
-
-        /* Number of touched points */
-        if(touch_cnt > CONFIG_ESP_LCD_TOUCH_MAX_POINTS)
-            touch_cnt = CONFIG_ESP_LCD_TOUCH_MAX_POINTS;
-
-        uint8_t valid_cnt = 0;
-        /* Fill all coordinates, filtering invalid ones */
-        for (i = 0; i < touch_cnt; i++) {
-            uint16_t raw_x = (uint16_t)(((uint16_t)(buf[(i * 6) ] & 0x0F) << 8) + (buf[(i * 6) + 1]));               
-            uint16_t raw_y = (uint16_t)(((uint16_t)(buf[(i * 6) + 2] & 0x0F) << 8) + (buf[(i * 6) + 3]));
-            
-            /* Check event type - upper nibble of first byte: 0=down, 1=up, 2=contact */
-            uint8_t event = (buf[(i * 6)] >> 4) & 0x0F;
-            
-            /* Discard if coordinates out of range or event is "up" (lift-off) */
-            if (raw_x >= tp->config.x_max || raw_y >= tp->config.y_max || event == 1) {
-                continue;
-            }
-            
-            tp->data.coords[valid_cnt].x = raw_x;
-            tp->data.coords[valid_cnt].y = raw_y;
-            tp->data.coords[valid_cnt].strength = 50;
-            valid_cnt++;
-        }
-        tp->data.points = valid_cnt;
+        touch_cst820_i2c_write(tp, TOUCH_NUM, &clear, 1);
 
-        taskEXIT_CRITICAL(&tp->data.lock);
+        set_points(tp, buf, touch_cnt);
     }
 
     return ESP_OK;
 }
 
+/* Finger count and point records in one auto-increment read from TOUCH_NUM */
+static esp_err_t read_data_burst(esp_lcd_touch_handle_t tp)
+{
+    uint8_t buf[1 + 6 * POINT_NUM_MAX];
+
+    ESP_RETURN_ON_ERROR(i2c_read_bytes(tp, TOUCH_NUM, buf, sizeof(buf)), TAG, "I2C read error!");
+
+    uint8_t touch_cnt = buf[0] & 0x0F;
+    if (touch_cnt > 2 || touch_cnt == 0) {
+        clear_points(tp);
+        return ESP_OK;
+    }
+    if (touch_cnt > POINT_NUM_MAX) {
+        touch_cnt = POINT_NUM_MAX;
+    }
+    set_points(tp, &buf[1], touch_cnt);
+    return ESP_OK;
+}
+
+static void record_timing(cst820_read_mode_t mode, int64_t us, esp_err_t err)
+{
+    uint32_t lat = us > 0 ? (uint32_t)us : 0;
+    portENTER_CRITICAL(&s_timing_lock);
+    s_timing.mode = mode;
+    s_timing.reports++;
+    if (err != ESP_OK) s_timing.errors++;
+    s_timing.last_us = lat;
+    if (lat > s_timing.max_us) s_timing.max_us = lat;
+    s_timing.total_us += lat;
+    s_timing.last_txns = s_report_txns;
+    portEXIT_CRITICAL(&s_timing_lock);
+
+#if CST820_TIMING_LOG_EVERY
+    if (s_timing.reports % CST820_TIMING_LOG_EVERY == 0) {
+        ESP_LOGI(TAG, "%s: %lu reports, avg %llu us, max %lu us, %u txns/report",
+                 mode == CST820_READ_BURST ? "burst" : "legacy", (unsigned long)s_timing.reports,
+                 (unsigned long long)(s_timing.total_us / s_timing.reports), (unsigned long)s_timing.max_us,
+                 s_timing.last_txns);
+    }
+#endif
+}
+
+static esp_err_t read_data(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+
+    cst820_read_mode_t mode = s_read_mode;
+    s_report_txns = 0;
+    int64_t t0 = esp_timer_get_time();
+
+    esp_err_t err;
+    if (mode == CST820_READ_BURST) {
+        err = read_data_burst(tp);
+        if (err == ESP_OK) {
+            s_burst_failures = 0;
+        } else if (++s_burst_failures >= CST820_BURST_FAIL_LIMIT) {
+            ESP_LOGW(TAG, "Burst read failed %d times, falling back to the legacy sequence", s_burst_failures);
+            s_read_mode = CST820_READ_LEGACY;
+        }
+    } else {
+        err = read_data_legacy(tp);
+    }
+
+    record_timing(mode, esp_timer_get_time() - t0, err);
+    return err;
+}
+
 static bool get_xy(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num)
 {
     portENTER_CRITICAL(&tp->data.lock);
@@ -215,6 +298,10 @@ static esp_err_t read_id(esp_lcd_touch_handle_t tp)
 
     ESP_RETURN_ON_ERROR(i2c_read_bytes(tp, CHIP_ID_REG, &id, 1), TAG, "I2C read failed");
     ESP_LOGI(TAG, "IC id: %d", id);
+
+    /* The legacy read rewrites this on every report; the burst read relies on it being set once */
+    uint8_t close = 1;
+    touch_cst820_i2c_write(tp, DIS_AUTO_SLEEP_REG, &close, 1);
     return ESP_OK;
 }
 
@@ -224,20 +311,104 @@ static esp_err_t i2c_read_bytes(esp_lcd_touch_handle_t tp, uint16_t reg, uint8_t
     assert(tp != NULL);
     assert(data != NULL);
 
-    /* Read data */
-    return esp_lcd_panel_io_rx_param(tp->io, reg, data, len);
+    s_report_txns++;
+    /* Read data: through the bus task at touch priority, never queued behind RTC/IMU traffic */
+    return I2C_Read_Prio(ESP_LCD_TOUCH_IO_I2C_CST820_ADDRESS, (uint8_t)reg, data, len, I2C_PRIO_HIGH);
 }
 
 static esp_err_t touch_cst820_i2c_write(esp_lcd_touch_handle_t tp, uint16_t reg, uint8_t* data, uint8_t len)
 {
     assert(tp != NULL);
 
+    s_report_txns++;
     // *INDENT-OFF*
     /* Write data */
-    return esp_lcd_panel_io_tx_param(tp->io, reg, data, len);
+    return I2C_Write_Prio(ESP_LCD_TOUCH_IO_I2C_CST820_ADDRESS, (uint8_t)reg, data, len, I2C_PRIO_HIGH);
     // *INDENT-ON*
 }
 
+void CST820_Set_Read_Mode(cst820_read_mode_t Mode)
+{
+    s_burst_failures = 0;
+    s_read_mode = Mode;
+    portENTER_CRITICAL(&s_timing_lock);
+    memset(&s_timing, 0, sizeof(s_timing));
+    portEXIT_CRITICAL(&s_timing_lock);
+}
+
+void CST820_Get_Timing(cst820_timing_t *Timing)
+{
+    portENTER_CRITICAL(&s_timing_lock);
+    *Timing = s_timing;
+    portEXIT_CRITICAL(&s_timing_lock);
+}
+
+#if TOUCH_USE_INTERRUPT
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Published point, one word so readers never see x and y from different
+ * reports: bit 31 pressed, bit 30 press not yet seen by a reader,
+ * bits 12..23 y, bits 0..11 x. */
+#define SLOT_PRESSED        (1u << 31)
+#define SLOT_STICKY         (1u << 30)
+#define SLOT_XY_MASK        0x00FFFFFFu
+
+static _Atomic uint32_t s_touch_slot = 0;
+static TaskHandle_t s_touch_task = NULL;
+
+static void IRAM_ATTR touch_isr(esp_lcd_touch_handle_t handle)
+{
+    BaseType_t wake = pdFALSE;
+    if (s_touch_task) {
+        vTaskNotifyGiveFromISR(s_touch_task, &wake);
+    }
+    if (wake) portYIELD_FROM_ISR();
+}
+
+static void publish_touch(bool pressed, uint16_t x, uint16_t y)
+{
+    if (pressed) {
+        uint32_t v = SLOT_PRESSED | SLOT_STICKY | ((uint32_t)(y & 0xFFF) << 12) | (x & 0xFFF);
+        atomic_store_explicit(&s_touch_slot, v, memory_order_release);
+        return;
+    }
+    /* Release: keep the last point and any unseen press */
+    uint32_t old = atomic_load_explicit(&s_touch_slot, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&s_touch_slot, &old, old & ~SLOT_PRESSED,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Reads the controller once per INT edge. While a finger is down the
+ *        CST820 keeps pulsing INT; when it goes quiet a single poll confirms
+ *        the lift-off, after which the task (and the bus) stays idle.
+ */
+static void touch_task_fn(void *arg)
+{
+    bool pressed = false;
+    for (;;) {
+        TickType_t wait = pressed ? pdMS_TO_TICKS(TOUCH_RELEASE_POLL_MS) : portMAX_DELAY;
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        uint16_t x = 0, y = 0;
+        uint8_t cnt = 0;
+        if (esp_lcd_touch_read_data(tp) != ESP_OK) {
+            continue;
+        }
+        pressed = esp_lcd_touch_get_coordinates(tp, &x, &y, NULL, &cnt, 1) && cnt > 0;
+        publish_touch(pressed, x, y);
+    }
+}
+
+bool Touch_Get_Point(uint16_t *x, uint16_t *y)
+{
+    uint32_t v = atomic_fetch_and_explicit(&s_touch_slot, ~SLOT_STICKY, memory_order_acquire);
+    *x = v & 0xFFF;
+    *y = (v >> 12) & 0xFFF;
+    return (v & (SLOT_PRESSED | SLOT_STICKY)) != 0;
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 esp_lcd_touch_handle_t tp = NULL;
 void Touch_Init(void)
@@ -248,7 +419,7 @@ void Touch_Init(void)
     esp_lcd_panel_io_handle_t tp_io_handle = NULL;
     esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_CST820_CONFIG();
     ESP_LOGI(TAG, "Initialize touch IO (I2C)");
-    /* Touch IO handle */
+    /* Touch IO handle (kept for esp_lcd_touch; register traffic goes through the I2C bus task) */
     ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c(i2c_bus_handle, &tp_io_config, &tp_io_handle));
     esp_lcd_touch_config_t tp_cfg = {
         .x_max = EXAMPLE_LCD_V_RES,
@@ -260,8 +431,15 @@ void Touch_Init(void)
             .mirror_x = 0,
             .mirror_y = 0,
         },
+#if TOUCH_USE_INTERRUPT
+        .interrupt_callback = touch_isr,
+#endif
     };
     /* Initialize touch */
     ESP_LOGI(TAG, "Initialize touch controller CST820");
     ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_cst820(tp_io_handle, &tp_cfg, &tp));
+#if TOUCH_USE_INTERRUPT
+    xTaskCreatePinnedToCore(touch_task_fn, "touch", TOUCH_TASK_STACK, NULL, TOUCH_TASK_PRIORITY, &s_touch_task, 1);
+    xTaskNotifyGive(s_touch_task);     // Pick up a touch already in progress (its edges came before the task)
+#endif
 }
\ No newline at end of file
@@ -63,6 +63,47 @@ esp_err_t esp_lcd_touch_new_i2c_cst820(const esp_lcd_panel_io_handle_t io, const
 #define I2C_Touch_INT_IO            16         /*!< GPIO number used for I2C master data  */
 #define I2C_Touch_RST_IO            -1         /*!< GPIO number used for I2C master clock */
 
+/* Interrupt-driven acquisition: the controller is only read after an INT
+ * edge, and the LVGL indev reads the latest point from a lock-free slot.
+ * 0 = read the controller on every indev poll (original behaviour). */
+#define TOUCH_USE_INTERRUPT         1
+#define TOUCH_TASK_PRIORITY         5
+#define TOUCH_TASK_STACK            3072
+#define TOUCH_RELEASE_POLL_MS       100        /*!< While pressed, re-read if INT stays quiet this long (missed lift-off) */
+
+/* Report read protocol. BURST fetches the finger count and point records in
+ * one auto-increment read; LEGACY is the original seven-transaction vendor
+ * sequence, used as the fallback if burst reads keep failing. */
+typedef enum {
+    CST820_READ_LEGACY = 0,
+    CST820_READ_BURST,
+} cst820_read_mode_t;
+
+#define CST820_READ_MODE            CST820_READ_BURST
+#define CST820_BURST_FAIL_LIMIT     5          /*!< Consecutive burst errors before switching to LEGACY */
+#define CST820_TIMING_LOG_EVERY     0          /*!< Log a timing summary every N reports (0 = off) */
+
+/* Per-report timing, for comparing the two protocols */
+typedef struct {
+    cst820_read_mode_t mode;                   /*!< Mode of the last report */
+    uint32_t reports;
+    uint32_t errors;
+    uint32_t last_us;                          /*!< Duration of the last report read */
+    uint32_t max_us;
+    uint64_t total_us;
+    uint8_t  last_txns;                        /*!< I2C transactions in the last report */
+} cst820_timing_t;
+
 extern esp_lcd_touch_handle_t tp;
 
 void Touch_Init(void);
+void CST820_Set_Read_Mode(cst820_read_mode_t Mode);     // Also clears the timing counters
+void CST820_Get_Timing(cst820_timing_t *Timing);
+#if TOUCH_USE_INTERRUPT
+/**
+ * @brief Latest touch state, lock-free and safe from any task. A press that
+ *        was released before anyone looked is still reported once.
+ * @return true if pressed; x/y hold the point (last known on release)
+ */
+bool Touch_Get_Point(uint16_t *x, uint16_t *y);
+#endif
@@ -17,8 +17,11 @@
 //#include "Wireless.h"
 #include "lvgl.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "Driver_Events.h"
 #include "Thermistor.h"
 #include "Buttons.h"
+#include "Spray.h"
 
 static const char *TAG = "main";
 
@@ -32,73 +35,144 @@ void refresh_screen(void) {
     lvgl_port_unlock();
 }
 
+/* Wakes the driver task once a second for the RTC read and periodic logs */
+static void rtc_tick_cb(void *arg)
+{
+    Driver_Events_Post(DRIVER_EVT_RTC_TICK);
+}
+
 void Driver_Loop(void *parameter)
 {
     static int therm_log_counter = 0;
+    static bool prev_relay_state = false;
+    static bool prev_brownout = false;          // Storage starts open; only real transitions act
+    sensor_reader_t ctrl_reader;                // Control engine's own ring cursor
+    sensor_sample_t samples[8];
 #if ENABLE_BUTTONS
     static bool prev_power_state = false;
     static bool prev_tank_state = false;
+    static bool buttons_applied = false;        // First pass pushes both states to the UI
 #endif
 
+    Driver_Events_Register();
+    Sensor_Ring_ReaderInit(&ctrl_reader);
+
+    // First pass handles every source once, in case it changed before we registered
+    uint32_t events = DRIVER_EVT_ALL;
+
     while(1)
     {
-       // QMI8658_Loop();
-        RTC_Loop();
-       // BAT_Get_Volts();
-
-        // --- Read thermistor and update UI ---
-        float temp = Thermistor_ReadTemp();
-        int raw_mv = Thermistor_ReadRawMV();
-        if (++therm_log_counter >= 20) {  // Log every 2 seconds (2 x 1000ms)
-            ESP_LOGI(TAG, "Thermistor: %d mV, %.1f°C", raw_mv, temp);
-            therm_log_counter = 0;
-        
-        if (temp > -900.0f) {  // Valid reading
-            if (lvgl_port_lock(0)) {
-                intercooler_ui_update_temperature(temp);
-                lvgl_port_unlock();
+        // --- Supply brown-out: close the SD log and hold off settings writes before the rail collapses ---
+        bool brownout = BAT_Brownout();
+        if ((events & DRIVER_EVT_SUPPLY) && brownout != prev_brownout) {
+            tlm_record_t rec;
+            prev_brownout = brownout;
+            if (brownout) {
+                ESP_LOGW(TAG, "Supply brown-out (%ld mV), closing storage", (long)BAT_Get_Supply_mV());
+                Telemetry_Health(&rec, esp_timer_get_time(), TLM_HEALTH_BROWNOUT, 0xFF, BAT_Get_Supply_mV(), 0);
+                SD_Logger_Record(&rec);
+                settings_set_writable(false);
+                SD_Logger_Suspend();
+            } else {
+                SD_Logger_Resume();
+                settings_set_writable(true);
+                Telemetry_Health(&rec, esp_timer_get_time(), TLM_HEALTH_SUPPLY_OK, 0xFF, BAT_Get_Supply_mV(), 0);
+                SD_Logger_Record(&rec);
+                ESP_LOGI(TAG, "Supply recovered (%ld mV), storage reopened", (long)BAT_Get_Supply_mV());
             }
         }
+
+        if (events & DRIVER_EVT_RTC_TICK) {
+           // QMI8658_Loop();
+            RTC_Loop();
+
+            // Temperature display is refreshed by the UI itself from the sensor ring
+            if (++therm_log_counter >= 2) {  // Log every 2 seconds
+                for (therm_channel_id_t ch = 0; ch < THERM_CH_COUNT; ch++) {
+                    if (Thermistor_ChannelEnabled(ch)) {
+                        float temp_c;
+                        sensor_health_t health = Thermistor_ReadChannel(ch, &temp_c);
+                        ESP_LOGI(TAG, "Thermistor %s: %d mV, %.1f°C (%s)", Thermistor_ChannelName(ch),
+                                 Thermistor_ReadChannelRawMV(ch), temp_c,
+                                 health == SENSOR_HEALTH_OK ? "ok" : health == SENSOR_HEALTH_FAULT ? "FAULT" : "suspect");
+                    }
+                }
+                therm_log_counter = 0;
+            }
         }
 
-#if ENABLE_BUTTONS
-        // --- Read buttons and update UI ---
-        bool power_on = Button_Power_GetState();
-        if (power_on != prev_power_state) {
-            if (lvgl_port_lock(0)) {
-                intercooler_ui_set_power_on(power_on);
-                lvgl_port_unlock();
+        // --- Spray engine: every new ring sample, ON edge here, OFF edge on its own esp_timer ---
+        if (events & DRIVER_EVT_SENSOR) {
+            size_t n;
+            while ((n = Sensor_Ring_Read(&ctrl_reader, samples, sizeof(samples) / sizeof(samples[0]))) > 0) {
+                for (size_t i = 0; i < n; i++) {
+                    Spray_Evaluate(&samples[i]);
+                }
             }
-            prev_power_state = power_on;
         }
 
-        bool tank_empty = Button_Tank_GetState();
-        if (tank_empty != prev_tank_state) {
-            if (lvgl_port_lock(0)) {
-                intercooler_ui_set_tank_empty(tank_empty);
-                lvgl_port_unlock();
+        if (events & (DRIVER_EVT_SPRAY | DRIVER_EVT_SENSOR)) {
+            bool relay_on = Spray_IsActive();
+            if (relay_on != prev_relay_state) {
+                if (lvgl_port_lock(0)) {
+                    intercooler_ui_set_relay_active(relay_on);
+                    lvgl_port_unlock();
+                }
+                prev_relay_state = relay_on;
             }
-            prev_tank_state = tank_empty;
+        }
+
+#if ENABLE_BUTTONS
+        // --- Buttons: posted by the debounce timers, so this runs ~50 ms after the edge ---
+        if (events & DRIVER_EVT_BUTTON) {
+            bool power_on = Button_Power_GetState();
+            if (power_on != prev_power_state || !buttons_applied) {
+                Spray_SetEnabled(power_on);
+                if (lvgl_port_lock(0)) {
+                    intercooler_ui_set_power_on(power_on);
+                    lvgl_port_unlock();
+                }
+                prev_power_state = power_on;
+            }
+
+            bool tank_empty = Button_Tank_GetState();
+            if (tank_empty != prev_tank_state || !buttons_applied) {
+                Spray_SetTankEmpty(tank_empty);
+                if (lvgl_port_lock(0)) {
+                    intercooler_ui_set_tank_empty(tank_empty);
+                    lvgl_port_unlock();
+                }
+                prev_tank_state = tank_empty;
+            }
+            buttons_applied = true;
         }
 #endif
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+        events = Driver_Events_Wait(portMAX_DELAY);
     }
     vTaskDelete(NULL);
 }
 void Driver_Init(void)
 {
     Flash_Searching();
-    //BAT_Init();
+#if BAT_MONITOR_ENABLED
+    BAT_Init();                     // Calibration only; sampled by the thermistor ADC scan (oneshot if it fails)
+#endif
     I2C_Init();
     PCF85063_Init();
-   // QMI8658_Init();
+#if IMU_FIFO_ENABLE
+    QMI8658_Init();
+    QMI8658_FIFO_Start();           // Watermark-drained FIFO, vibration summaries to the SD log
+#endif
     EXIO_Init();                    // Example Initialize EXIO
     ESP_LOGI(TAG, "EXIO init done, starting Thermistor...");
-    Thermistor_Init();               // Initialize thermistor ADC on GPIO19
+    Thermistor_Init();               // Start continuous (DMA) scan of every thermistor channel
     ESP_LOGI(TAG, "Thermistor init done");
+    Spray_Init();                    // Relay EXIO + one-shot edge timers
 #if ENABLE_BUTTONS
     Buttons_Init();                  // Initialize buttons on GPIO43/44 (disables UART!)
+    Spray_SetEnabled(Button_Power_GetState());      // Before the control loop can start a cycle
+    Spray_SetTankEmpty(Button_Tank_GetState());
     ESP_LOGI(TAG, "Buttons init done");
 #endif
     xTaskCreatePinnedToCore(
@@ -109,6 +183,14 @@ void Driver_Init(void)
         3, 
         NULL, 
         0);
+
+    const esp_timer_create_args_t rtc_tick_args = {
+        .callback = rtc_tick_cb,
+        .name = "rtc_tick",
+    };
+    esp_timer_handle_t rtc_tick_timer;
+    ESP_ERROR_CHECK(esp_timer_create(&rtc_tick_args, &rtc_tick_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(rtc_tick_timer, 1000000));
 }
 void app_main(void)
 {   
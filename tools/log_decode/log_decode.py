@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Host-side decoder for the deferred log files (D%05d.bin) written next to
+each SD text log. The device stores every ESP_LOGx call as the address of
+its format string plus the raw arguments (main/SD_Logger/Log_Defer.h);
+this reads the strings back out of the app ELF and does the printf.
+
+Run with the ELF of the exact build that wrote the file:
+  tools/log_decode/log_decode.py build/<project>.elf D00012.bin > L00012.log
+  tools/log_decode/log_decode.py --us build/<project>.elf D00012.bin   # prefix esp_timer us
+
+No third-party modules: the ELF section headers are parsed directly.
+"""
+import argparse
+import hashlib
+import re
+import struct
+import sys
+
+MAGIC = b'ICDL'
+VERSION = 1
+HEADER = struct.Struct('<4sHH64sqq')
+ENTRY = struct.Struct('<HIq')
+
+# One printf conversion, as walked by Log_Defer_Encode()
+SPEC = re.compile(r'%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?'
+                  r'(?P<len>hh|h|ll|l|j|z|t)?(?P<conv>[diuxXocpfFeEgGaAs%])')
+
+
+class Elf:
+    """Maps load addresses to bytes using the allocated PROGBITS sections."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError(f'{path}: not an ELF file')
+        is64 = self.data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from('<Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from('<HH', self.data, 0x3A)
+            sh = struct.Struct('<IIQQQQIIQQ')
+        else:
+            shoff, = struct.unpack_from('<I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+            sh = struct.Struct('<IIIIIIIIII')
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = sh.unpack_from(self.data, shoff + i * shentsize)[:6]
+            if sh_type == 1 and flags & 0x2 and size:      # SHT_PROGBITS, SHF_ALLOC
+                self.sections.append((addr, size, offset))
+        self.sha256 = hashlib.sha256(self.data).hexdigest()
+
+    def string(self, addr):
+        for base, size, offset in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.find(b'\0', start, offset + size)
+                return self.data[start:end if end >= 0 else offset + size].decode('utf-8', 'replace')
+        return f'<unknown string @0x{addr:08x}>'
+
+
+def read_args(payload, elf):
+    """Decode the tagged argument list into Python values."""
+    args, pos = [], 0
+    while pos < len(payload):
+        tag = chr(payload[pos])
+        pos += 1
+        if tag == 'i':
+            args.append(('i', struct.unpack_from('<i', payload, pos)[0]))
+            pos += 4
+        elif tag == 'l':
+            args.append(('l', struct.unpack_from('<q', payload, pos)[0]))
+            pos += 8
+        elif tag == 'd':
+            args.append(('d', struct.unpack_from('<d', payload, pos)[0]))
+            pos += 8
+        elif tag == 'r':
+            args.append(('s', elf.string(struct.unpack_from('<I', payload, pos)[0])))
+            pos += 4
+        elif tag == 's':
+            n = payload[pos]
+            args.append(('s', payload[pos + 1:pos + 1 + n].decode('utf-8', 'replace')))
+            pos += 1 + n
+        else:
+            raise ValueError(f'bad argument tag 0x{payload[pos - 1]:02x}')
+    return args
+
+
+def render(fmt, args):
+    """printf(fmt, args) with C semantics for the conversions the encoder accepts."""
+    it = iter(args)
+    out, last = [], 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        conv = m.group('conv')
+        if conv == '%':
+            out.append('%')
+            continue
+        width, prec = m.group('width'), m.group('prec')
+        if width == '*':
+            width = str(next(it)[1])
+        if prec == '*':
+            prec = str(next(it)[1])
+        kind, value = next(it)
+        flags = m.group('flags')
+        if conv in 'uxXo':
+            value &= 0xFFFFFFFF if kind == 'i' else 0xFFFFFFFFFFFFFFFF
+            conv = 'd' if conv == 'u' else conv
+        elif conv == 'p':
+            value &= 0xFFFFFFFF if kind == 'i' else 0xFFFFFFFFFFFFFFFF
+            flags, conv = flags + '#', 'x'
+        elif conv == 'c':
+            value = chr(value & 0xFF)
+            conv = 's'
+        elif conv in 'aA':
+            text = float(value).hex()
+            out.append(text.upper() if conv == 'A' else text)
+            continue
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '') + conv
+        out.append(spec % value)
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('elf')
+    ap.add_argument('log')
+    ap.add_argument('--us', action='store_true', help='prefix each line with its esp_timer timestamp')
+    opts = ap.parse_args()
+
+    elf = Elf(opts.elf)
+    with open(opts.log, 'rb') as f:
+        data = f.read()
+    magic, version, header_bytes, sha, epoch_us, t0_us = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit(f'{opts.log}: not a version {VERSION} deferred log')
+    sha = sha.rstrip(b'\0').decode()
+    if sha and not elf.sha256.startswith(sha):
+        print(f'warning: log was written by ELF {sha[:16]}, this is {elf.sha256[:16]}', file=sys.stderr)
+    print(f'# T0,epoch_us={epoch_us},timestamp_us={t0_us}')
+
+    pos, count = header_bytes, 0
+    while pos + ENTRY.size <= len(data):
+        length, fmt_addr, ts = ENTRY.unpack_from(data, pos)
+        if length == 0:
+            break                   # zero padding of a preallocated file that was never closed
+        if length < ENTRY.size or pos + length > len(data):
+            print(f'warning: truncated or corrupt entry at offset {pos}, stopping', file=sys.stderr)
+            break
+        try:
+            text = render(elf.string(fmt_addr), read_args(data[pos + ENTRY.size:pos + length], elf))
+        except (ValueError, StopIteration, TypeError) as e:
+            text = f'<undecodable entry @0x{fmt_addr:08x}: {e}>\n'
+        if opts.us:
+            text = f'[{ts}] ' + text
+        sys.stdout.write(text)
+        pos += length
+        count += 1
+    print(f'{count} entries', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
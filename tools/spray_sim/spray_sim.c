@@ -0,0 +1,192 @@
+/*
+ * Host-side simulation harness for the DUTY spray mode.
+ *
+ * Runs the firmware's controller (main/Spray/Spray_PID.c) and trend fit
+ * (main/Thermistor/Therm_Trend.c) against a lumped thermal model of the
+ * intercooler, next to the fixed duration/interval (ABSOLUTE) mode, and
+ * prints water use and temperature error for both so gains can be tuned
+ * before they go into Spray.h.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -Imain/Spray -Imain/Thermistor tools/spray_sim/spray_sim.c \
+ *      main/Spray/Spray_PID.c main/Thermistor/Therm_Trend.c -lm -o spray_sim
+ *   ./spray_sim                        # defaults from Spray.h
+ *   ./spray_sim 0.2 0.01 0.3           # kp ki kd
+ *   ./spray_sim 0.2 0.01 0.3 csv > trace.csv
+ *
+ * Model (1 ms step):
+ *   core:  C dT/dt = h_in (T_charge - T) - h_amb (T - T_amb) - P_spray * relay
+ *   probe: first-order lag, tau = PROBE_TAU_S, read at 10 Hz
+ *   drive: cruise with T_charge = 55 °C, boost pulls for 12 s every 45 s,
+ *          plus a 3 min sustained pull in the middle. Run twice: pulls to
+ *          120 °C (track) and to 70 °C (road, mild over-temperature).
+ *          CSV output is the 120 °C run.
+ * The constants are rough figures for an air-to-air core with a water
+ * spray bar; adjust them to match logged data before trusting the gains.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Spray_PID.h"
+#include "Therm_Trend.h"
+
+/* Firmware defaults (keep in sync with Spray.h / Thermistor.h) */
+#define TRIGGER_C           40.0f
+#define PERIOD_MS           10000
+#define MIN_PULSE_MS        500
+#define DEF_KP              0.08f
+#define DEF_KI              0.005f
+#define DEF_KD              0.30f
+#define ABS_DURATION_S      2.0f
+#define ABS_INTERVAL_S      10.0f
+#define PUBLISH_HZ          10
+#define TREND_WINDOW        30
+
+/* Thermal model */
+#define SIM_SECONDS         900
+#define DT_S                0.001f
+#define T_AMB_C             30.0f
+#define CORE_C_J_PER_K      4000.0f
+#define H_IN_W_PER_K        60.0f
+#define H_AMB_W_PER_K       120.0f
+#define P_SPRAY_W           3500.0f
+#define PROBE_TAU_S         2.0f
+#define PULL_HARD_C         120.0f      // Charge temperature under boost: track use
+#define PULL_MILD_C         70.0f       // Road use: the core settles just over the trigger
+
+typedef enum { MODE_ABSOLUTE, MODE_DUTY } sim_mode_t;
+
+typedef struct {
+    float water_s;          // Relay ON time
+    float over_cs;          // ∫ max(0, T - trigger) dt, °C·s
+    float abs_err_cs;       // ∫ |T - trigger| dt while the charge is hot
+    float peak_c;
+    int   pulses;
+} sim_result_t;
+
+static float charge_temp(float t, float pull_c)
+{
+    if (t >= 300.0f && t < 480.0f) return pull_c;     /* Sustained pull */
+    return fmodf(t, 45.0f) < 12.0f ? pull_c : 55.0f;
+}
+
+static sim_result_t run(sim_mode_t mode, const spray_pid_cfg_t *gains, float pull_c, FILE *csv)
+{
+    sim_result_t r = { 0 };
+    float core = T_AMB_C + 10.0f;
+    float probe = core;
+    bool relay = false;
+    float on_left_s = 0.0f;         /* Remaining ON time of the current pulse */
+    float holdoff_left_s = 0.0f;    /* ABSOLUTE mode hold-off */
+    float next_pid_s = 0.0f;
+    float duty = 0.0f;
+
+    spray_pid_t pid;
+    Spray_PID_Init(&pid, gains);
+    therm_trend_t trend;
+    Therm_Trend_Init(&trend, TREND_WINDOW);
+
+    int steps_per_reading = (int)(1.0f / (DT_S * PUBLISH_HZ) + 0.5f);
+    long steps = (long)(SIM_SECONDS / DT_S);
+    float rate = 0.0f;
+
+    for (long i = 0; i < steps; i++) {
+        float t = i * DT_S;
+
+        /* Plant */
+        float q = H_IN_W_PER_K * (charge_temp(t, pull_c) - core) - H_AMB_W_PER_K * (core - T_AMB_C);
+        if (relay) q -= P_SPRAY_W;
+        core += q / CORE_C_J_PER_K * DT_S;
+        probe += (core - probe) * DT_S / PROBE_TAU_S;
+
+        /* Relay timing */
+        if (relay) {
+            on_left_s -= DT_S;
+            r.water_s += DT_S;
+            if (on_left_s <= 0.0f) {
+                relay = false;
+                holdoff_left_s = (mode == MODE_ABSOLUTE) ? ABS_INTERVAL_S : 0.0f;
+            }
+        } else if (holdoff_left_s > 0.0f) {
+            holdoff_left_s -= DT_S;
+        }
+
+        /* Sensor pipeline at the publish rate */
+        if (i % steps_per_reading == 0) {
+            float fit_now;
+            Therm_Trend_Push(&trend, (int32_t)lrintf(probe * 100.0f));
+            if (!Therm_Trend_Get(&trend, PUBLISH_HZ, &rate, &fit_now)) rate = 0.0f;
+
+            if (mode == MODE_ABSOLUTE && !relay && holdoff_left_s <= 0.0f && probe >= TRIGGER_C) {
+                relay = true;
+                on_left_s = ABS_DURATION_S;
+                r.pulses++;
+            }
+            if (csv) {
+                fprintf(csv, "%.1f,%s,%.2f,%.2f,%.2f,%.3f,%d\n", t, mode == MODE_DUTY ? "duty" : "absolute",
+                        charge_temp(t, pull_c), core, probe, duty, relay);
+            }
+        }
+
+        /* DUTY controller at the modulation period */
+        if (mode == MODE_DUTY && t >= next_pid_s) {
+            next_pid_s += PERIOD_MS / 1000.0f;
+            duty = Spray_PID_Update(&pid, probe - TRIGGER_C, rate, PERIOD_MS / 1000.0f);
+            uint32_t on_ms = Spray_PID_PulseMs(duty, PERIOD_MS, MIN_PULSE_MS);
+            if (on_ms > 0) {
+                if (!relay) r.pulses++;
+                relay = true;
+                on_left_s = on_ms / 1000.0f;
+            }
+        }
+
+        /* Metrics on the true core temperature */
+        float err = core - TRIGGER_C;
+        if (err > 0.0f) r.over_cs += err * DT_S;
+        if (core > TRIGGER_C - 5.0f) r.abs_err_cs += fabsf(err) * DT_S;
+        if (core > r.peak_c) r.peak_c = core;
+    }
+    return r;
+}
+
+static void print_result(const char *name, const sim_result_t *r)
+{
+    printf("%-10s water %6.1f s  pulses %4d  over-trigger %8.1f °C·s  |err| %8.1f °C·s  peak %5.1f °C\n",
+           name, r->water_s, r->pulses, r->over_cs, r->abs_err_cs, r->peak_c);
+}
+
+int main(int argc, char **argv)
+{
+    spray_pid_cfg_t gains = { .kp = DEF_KP, .ki = DEF_KI, .kd = DEF_KD };
+    bool csv = false;
+
+    if (argc >= 4) {
+        gains.kp = strtof(argv[1], NULL);
+        gains.ki = strtof(argv[2], NULL);
+        gains.kd = strtof(argv[3], NULL);
+    }
+    if (argc >= 5 && strcmp(argv[4], "csv") == 0) {
+        csv = true;
+    }
+
+    if (csv) {
+        printf("t_s,mode,charge_c,core_c,probe_c,duty,relay\n");
+        run(MODE_ABSOLUTE, &gains, PULL_HARD_C, stdout);
+        run(MODE_DUTY, &gains, PULL_HARD_C, stdout);
+        return 0;
+    }
+
+    printf("Trigger %.0f °C, %d s simulated, kp %.3f ki %.4f kd %.3f\n",
+           TRIGGER_C, SIM_SECONDS, gains.kp, gains.ki, gains.kd);
+    const float pulls[] = { PULL_HARD_C, PULL_MILD_C };
+    for (size_t i = 0; i < sizeof(pulls) / sizeof(pulls[0]); i++) {
+        printf("Pulls to %.0f °C:\n", pulls[i]);
+        sim_result_t abs_r = run(MODE_ABSOLUTE, &gains, pulls[i], NULL);
+        sim_result_t duty_r = run(MODE_DUTY, &gains, pulls[i], NULL);
+        print_result("absolute", &abs_r);
+        print_result("duty", &duty_r);
+    }
+    return 0;
+}
@@ -0,0 +1,415 @@
+/*
+ * Host-side accuracy test, noise test and benchmark for the thermistor
+ * reading path.
+ *
+ * LUT: builds the firmware's ADC-code -> temperature table (main/
+ * Thermistor/Therm_LUT.c) for the default probe and checks it against the
+ * float model over the whole 0-3.3 V input: every integer code through
+ * Therm_LUT_Check(), and every 1/16 code in between, which is what an
+ * averaged block of oversampled readings looks up. Then times both paths
+ * per conversion, for the Beta and the Steinhart-Hart model.
+ *
+ * Filter: replays a trace of averaged divider voltages, one per published
+ * reading, through the same steps as code_to_sample() in Thermistor.c:
+ * LUT lookup, Therm_Filter, Sensor_Health_Check on the median, trend fit.
+ * Reports threshold chatter of the raw vs the published temperature,
+ * rejected readings by cause, latched faults, trigger lag and time per
+ * reading. The trace is either a recording (the S lines of tlm_decode
+ * output, raw_mv of one channel) or, without one, a built-in trace with
+ * ADC noise, 1-2 reading ignition spikes, a connector dropout and a real
+ * fast rise.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -Imain/Thermistor -Imain/Sensor tools/therm_bench/therm_bench.c \
+ *      main/Thermistor/Therm_LUT.c main/Thermistor/Therm_Filter.c \
+ *      main/Thermistor/Therm_Trend.c main/Sensor/Sensor_Health.c -lm -o therm_bench
+ *   ./therm_bench                          # built-in trace
+ *   ./therm_bench T00012.csv [ch] [trig]   # recording: channel (1 = outlet), trigger °C
+ *
+ * Exits non-zero if the table is worse than the bounds documented in
+ * Therm_LUT.h, or if the built-in trace chatters, latches a fault or
+ * flags a reading the filter should have absorbed.
+ *
+ * Host timings only show the ratio between the paths; the boot self-tests
+ * (THERMISTOR_*_SELFTEST in Thermistor.h) give cycles on the S3.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Sensor_Health.h"
+#include "Therm_Filter.h"
+#include "Therm_LUT.h"
+#include "Therm_Trend.h"
+
+/* Firmware defaults (keep in sync with Thermistor.h) */
+#define NOMINAL_R           100000.0f
+#define NOMINAL_T           25.0f
+#define BETA                3950.0f
+#define SERIES_R            100000.0f
+#define SH_A                0.000722378f
+#define SH_B                0.000216302f
+#define SH_C                9.26410e-08f
+#define PUBLISH_HZ          10
+#define FILTER_MEDIAN       5
+#define FILTER_ALPHA        0.3f
+#define FILTER_SLEW_C_PER_S 10.0f
+#define TREND_WINDOW        30
+#define CONTROL_CHANNEL     1           // THERM_CH_OUTLET
+
+/* Test limits */
+#define RANGE_MIN_C         -20.0f
+#define RANGE_MAX_C         150.0f
+#define MAX_ERR_BETA_C      0.07f       // Bounds claimed in Therm_LUT.h
+#define MAX_ERR_SH_C        0.09f
+#define SUB_STEPS           16          // Fractional codes checked per integer code
+#define BENCH_ROUNDS        200         // Passes over all codes (or the trace) per timing
+#define TRIGGER_C           40.0f       // Default threshold for the chatter count
+#define TRACE_MAX           (10 * 3600 * PUBLISH_HZ)    // Longest recording replayed (10 h)
+
+/* Built-in trace: 60 s at the publish rate */
+#define BUILTIN_SAMPLES     600
+#define BUILTIN_START_C     35.0f       // Slow ramp through the trigger ...
+#define BUILTIN_END_C       45.0f
+#define BUILTIN_NOISE_MV    3           // ± ADC noise left after oversampling
+#define BUILTIN_SPIKE_EVERY 23          // Readings between ignition spikes (none on the first:
+                                        // it primes every filter stage, see Therm_Filter_Step)
+#define BUILTIN_SPIKE_MV    160         // ~±8 °C near the trigger
+#define BUILTIN_DROP_AT     200         // ... a 3-reading connector dropout ...
+#define BUILTIN_DROP_LEN    3
+#define BUILTIN_STEP_AT     450         // ... and a real 10 °C rise in 2 s
+#define BUILTIN_STEP_C      10.0f
+#define BUILTIN_STEP_S      2.0f
+
+#define CODES               (1 << THERM_LUT_ADC_BITS)
+
+static volatile float s_sink_f;
+static volatile int32_t s_sink_i;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static float code_mv(float code)
+{
+    return code * THERM_LUT_FULL_SCALE_MV / (float)(CODES - 1);
+}
+
+/** Worst error at fractional codes, where the lookup interpolates inside a code */
+static float check_fractional(const therm_lut_t *lut, const therm_params_t *p, float *worst_code)
+{
+    float max_err = 0.0f;
+    for (uint32_t q8 = 0; q8 < ((uint32_t)(CODES - 1) << THERM_LUT_FRAC_BITS);
+         q8 += (1u << THERM_LUT_FRAC_BITS) / SUB_STEPS) {
+        float code = q8 / (float)(1 << THERM_LUT_FRAC_BITS);
+        float ref = Therm_Model_TempC(p, code_mv(code));
+        int16_t lut_c = Therm_LUT_Lookup(lut, q8);
+        if (ref < RANGE_MIN_C || ref > RANGE_MAX_C || lut_c == THERM_LUT_INVALID) continue;
+
+        float err = fabsf(lut_c / 100.0f - ref);
+        if (err > max_err) {
+            max_err = err;
+            *worst_code = code;
+        }
+    }
+    return max_err;
+}
+
+static bool run(const char *name, const therm_params_t *p, float max_err_c)
+{
+    static therm_lut_t lut;
+    Therm_LUT_Build(&lut, p);
+
+    therm_lut_check_t chk;
+    Therm_LUT_Check(&lut, p, RANGE_MIN_C, RANGE_MAX_C, &chk);
+    float frac_code = 0.0f;
+    float frac_err = check_fractional(&lut, p, &frac_code);
+
+    double t0 = now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int code = 0; code < CODES; code++) {
+            s_sink_f = Therm_Model_TempC(p, code_mv((float)code));
+        }
+    }
+    double t1 = now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int code = 0; code < CODES; code++) {
+            s_sink_i = Therm_LUT_Lookup(&lut, (uint32_t)code << THERM_LUT_FRAC_BITS);
+        }
+    }
+    double t2 = now_ns();
+    double n = (double)BENCH_ROUNDS * CODES;
+
+    bool ok = chk.max_err_c <= max_err_c && frac_err <= max_err_c;
+    printf("%-14s %4d codes in %.0f..%.0f °C  max error %.3f °C at code %d, %.3f °C at code %.4f  (limit %.2f) %s\n",
+           name, chk.compared, RANGE_MIN_C, RANGE_MAX_C, chk.max_err_c, chk.worst_code,
+           frac_err, frac_code, max_err_c, ok ? "ok" : "FAIL");
+    printf("%-14s float %.1f ns/conv, LUT %.1f ns/conv (%.1fx)\n",
+           "", (t1 - t0) / n, (t2 - t1) / n, (t1 - t0) / (t2 - t1));
+    return ok;
+}
+
+/***********************
+ *  FILTER + HEALTH
+ ***********************/
+typedef struct {
+    int readings, valid, trend;
+    int rate, open, shorted, stuck;     // Readings rejected for each cause
+    int faults;                         // Latches
+    int raw_cross, out_cross;           // Trigger crossings, raw vs published
+    int first_trigger;                  // First published reading at or above the trigger, -1 if none
+} pipe_result_t;
+
+static int32_t s_trace_mv[TRACE_MAX];
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/** Inverse of the Beta model: divider voltage for a probe temperature */
+static int32_t temp_to_mv(float t_c)
+{
+    float r = NOMINAL_R * expf(BETA * (1.0f / (t_c + 273.15f) - 1.0f / (NOMINAL_T + 273.15f)));
+    return (int32_t)lrintf(THERM_LUT_FULL_SCALE_MV * r / (SERIES_R + r));
+}
+
+static float builtin_temp(int i)
+{
+    float t = BUILTIN_START_C + (BUILTIN_END_C - BUILTIN_START_C) * i / (BUILTIN_SAMPLES - 1);
+    float step_s = (float)(i - BUILTIN_STEP_AT) / PUBLISH_HZ;
+    if (step_s > 0.0f) {
+        t += BUILTIN_STEP_C * (step_s < BUILTIN_STEP_S ? step_s / BUILTIN_STEP_S : 1.0f);
+    }
+    return t;
+}
+
+static int builtin_trace(void)
+{
+    uint32_t seed = 12345;
+    for (int i = 0; i < BUILTIN_SAMPLES; i++) {
+        int32_t mv = temp_to_mv(builtin_temp(i));
+        mv += (int32_t)(lcg_next(&seed) % (2 * BUILTIN_NOISE_MV + 1)) - BUILTIN_NOISE_MV;
+        if (i % BUILTIN_SPIKE_EVERY == BUILTIN_SPIKE_EVERY - 1) {
+            int len = 1 + (int)(lcg_next(&seed) & 1);
+            int32_t spike = (lcg_next(&seed) & 1) ? BUILTIN_SPIKE_MV : -BUILTIN_SPIKE_MV;
+            for (int k = 0; k < len && i + k < BUILTIN_SAMPLES; k++) {
+                s_trace_mv[i + k] = mv + spike;
+            }
+            i += len - 1;
+            continue;
+        }
+        s_trace_mv[i] = mv;
+    }
+    for (int i = BUILTIN_DROP_AT; i < BUILTIN_DROP_AT + BUILTIN_DROP_LEN; i++) {
+        s_trace_mv[i] = (int32_t)THERM_LUT_FULL_SCALE_MV;
+    }
+    return BUILTIN_SAMPLES;
+}
+
+/** raw_mv of one channel from the S lines of tlm_decode output */
+static int load_trace(const char *path, int ch)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[512];
+    int n = 0;
+    while (n < TRACE_MAX && fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "S,", 2) != 0) continue;
+        /* S,timestamp_us,seq,{raw_mv,temp_c,flags} x channels,supply_mv */
+        char *p = line;
+        for (int field = 0; field < 3 + 3 * ch && p; field++) {
+            p = strchr(p, ',');
+            if (p) p++;
+        }
+        if (!p) continue;
+        int32_t mv = (int32_t)strtol(p, NULL, 10);
+        if (mv < 0) continue;       /* Channel disabled */
+        s_trace_mv[n++] = mv;
+    }
+    fclose(f);
+    return n;
+}
+
+static void filter_cfg(therm_filter_cfg_t *cfg)
+{
+    cfg->median_len = FILTER_MEDIAN;
+    cfg->alpha_q15 = (uint16_t)(FILTER_ALPHA * THERM_FILTER_ALPHA_ONE);
+    cfg->slew_centi_c = (int32_t)(FILTER_SLEW_C_PER_S * 100.0f / PUBLISH_HZ);
+}
+
+/** Thermistor.c publish(): mV = code_q8 * 3300 / (4095 << 8), inverted */
+static uint32_t mv_to_code_q8(int32_t raw_mv)
+{
+    return (uint32_t)(((uint64_t)raw_mv * (4095u << THERM_LUT_FRAC_BITS) + (uint32_t)THERM_LUT_FULL_SCALE_MV / 2) /
+                      (uint32_t)THERM_LUT_FULL_SCALE_MV);
+}
+
+/** One channel through code_to_sample()'s steps (Thermistor.c) */
+static void pipe_run(const therm_lut_t *lut, int n, float trigger_c, pipe_result_t *r)
+{
+    therm_filter_cfg_t cfg;
+    therm_filter_t filter;
+    sensor_health_state_t health;
+    therm_trend_t trend;
+    filter_cfg(&cfg);
+    Therm_Filter_Init(&filter, &cfg);
+    Sensor_Health_Init(&health);
+    Therm_Trend_Init(&trend, TREND_WINDOW);
+
+    int32_t trigger = (int32_t)lrintf(trigger_c * 100.0f);
+    int raw_above = -1, out_above = -1;
+    bool latched = false;
+    memset(r, 0, sizeof(*r));
+    r->first_trigger = -1;
+
+    for (int i = 0; i < n; i++) {
+        int32_t raw_mv = s_trace_mv[i];
+        uint32_t code_q8 = mv_to_code_q8(raw_mv);
+        int16_t centi_c = Therm_LUT_Lookup(lut, code_q8);
+        bool in_range = centi_c != THERM_LUT_INVALID;
+
+        bool plausible = Sensor_Health_Plausible(raw_mv, in_range);
+        int32_t filtered = 0;
+        if (plausible) {
+            filtered = Therm_Filter_Step(&filter, centi_c);
+        }
+        uint32_t flags = Sensor_Health_Check(&health, raw_mv, code_q8, filter.median, plausible, PUBLISH_HZ);
+
+        r->readings++;
+        if ((flags & SENSOR_FLAG_FAULT) && !latched) r->faults++;
+        latched = (flags & SENSOR_FLAG_FAULT) != 0;
+        if (flags & SENSOR_FLAG_RATE) r->rate++;
+        if (flags & SENSOR_FLAG_OPEN) r->open++;
+        if (flags & SENSOR_FLAG_SHORT) r->shorted++;
+        if (flags & SENSOR_FLAG_STUCK) r->stuck++;
+
+        if (in_range) {
+            int above = centi_c >= trigger;
+            if (raw_above >= 0 && above != raw_above) r->raw_cross++;
+            raw_above = above;
+        }
+
+        if (flags & SENSOR_FLAG_VALID) {
+            float rate, fit_now;
+            r->valid++;
+            Therm_Trend_Push(&trend, filtered);
+            if (Therm_Trend_Get(&trend, PUBLISH_HZ, &rate, &fit_now)) r->trend++;
+
+            int above = filtered >= trigger;
+            if (out_above >= 0 && above != out_above) r->out_cross++;
+            out_above = above;
+            if (above && r->first_trigger < 0) r->first_trigger = i;
+            continue;
+        }
+
+        if (flags & SENSOR_FLAG_FAULT) {
+            Therm_Filter_Reset(&filter);
+        }
+        if (flags & (SENSOR_FLAG_FAULT | (SENSOR_FLAG_BAD_MASK & ~SENSOR_FLAG_RATE))) {
+            Therm_Trend_Reset(&trend);
+        }
+    }
+}
+
+static bool run_filter(const therm_lut_t *lut, int n, float trigger_c, bool builtin)
+{
+    pipe_result_t r;
+    pipe_run(lut, n, trigger_c, &r);
+
+    static int16_t centi[TRACE_MAX];
+    for (int i = 0; i < n; i++) {
+        centi[i] = Therm_LUT_Lookup(lut, mv_to_code_q8(s_trace_mv[i]));
+    }
+
+    double t0 = now_ns();
+    for (int k = 0; k < BENCH_ROUNDS; k++) {
+        pipe_result_t tmp;
+        pipe_run(lut, n, trigger_c, &tmp);
+        s_sink_i = tmp.valid;
+    }
+    double t1 = now_ns();
+    therm_filter_cfg_t cfg;
+    therm_filter_t filter;
+    filter_cfg(&cfg);
+    for (int k = 0; k < BENCH_ROUNDS; k++) {
+        Therm_Filter_Init(&filter, &cfg);
+        for (int i = 0; i < n; i++) {
+            s_sink_i = Therm_Filter_Step(&filter, centi[i]);
+        }
+    }
+    double t2 = now_ns();
+    double steps = (double)BENCH_ROUNDS * n;
+
+    printf("%d readings (%.1f s), trigger %.1f °C\n", r.readings, (double)r.readings / PUBLISH_HZ, trigger_c);
+    printf("  crossings       raw %d, published %d\n", r.raw_cross, r.out_cross);
+    printf("  published       %d valid (%.1f %%), %d with a trend\n", r.valid, 100.0 * r.valid / r.readings, r.trend);
+    printf("  rejected        rate %d, open %d, short %d, stuck %d; %d fault latch(es)\n",
+           r.rate, r.open, r.shorted, r.stuck, r.faults);
+    if (builtin) {
+        int ideal = -1;
+        for (int i = 0; i < BUILTIN_SAMPLES && ideal < 0; i++) {
+            if (builtin_temp(i) >= trigger_c) ideal = i;
+        }
+        printf("  first trigger   reading %d (noise-free %d, %+.1f s)\n",
+               r.first_trigger, ideal, (double)(r.first_trigger - ideal) / PUBLISH_HZ);
+    } else {
+        printf("  first trigger   reading %d\n", r.first_trigger);
+    }
+    printf("  time            %.1f ns/reading whole path, %.1f ns filter alone\n",
+           (t1 - t0) / steps, (t2 - t1) / steps);
+
+    if (!builtin) {
+        return true;
+    }
+    /* Spikes and the dropout are absorbed; only the dropout itself is rejected */
+    bool ok = r.out_cross == 1 && r.faults == 0 && r.rate == 0 && r.stuck == 0 && r.shorted == 0 &&
+              r.open == BUILTIN_DROP_LEN && r.first_trigger >= 0;
+    printf("  %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const therm_params_t beta = {
+        .model = THERM_MODEL_BETA, .series_r = SERIES_R,
+        .nominal_r = NOMINAL_R, .nominal_t = NOMINAL_T, .beta = BETA,
+    };
+    const therm_params_t sh = {
+        .model = THERM_MODEL_STEINHART_HART, .series_r = SERIES_R,
+        .sh_a = SH_A, .sh_b = SH_B, .sh_c = SH_C,
+    };
+
+    printf("LUT: %d-bit ADC, %d table entries\n", THERM_LUT_ADC_BITS, THERM_LUT_SIZE);
+    bool ok = run("beta", &beta, MAX_ERR_BETA_C);
+    ok = run("steinhart-hart", &sh, MAX_ERR_SH_C) && ok;
+
+    static therm_lut_t lut;
+    Therm_LUT_Build(&lut, &beta);
+    float trigger_c = argc >= 4 ? strtof(argv[3], NULL) : TRIGGER_C;
+    int n;
+    if (argc >= 2) {
+        int ch = argc >= 3 ? atoi(argv[2]) : CONTROL_CHANNEL;
+        n = load_trace(argv[1], ch);
+        if (n <= 0) {
+            fprintf(stderr, "%s: no S records for channel %d\n", argv[1], ch);
+            return EXIT_FAILURE;
+        }
+        printf("\nFilter: %s, channel %d, ", argv[1], ch);
+    } else {
+        n = builtin_trace();
+        printf("\nFilter: built-in trace, ");
+    }
+    ok = run_filter(&lut, n, trigger_c, argc < 2) && ok;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
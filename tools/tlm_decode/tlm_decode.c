@@ -0,0 +1,153 @@
+/*
+ * Host-side decoder for the binary telemetry files (T%05d.bin) written
+ * next to each SD text log. The record layout comes straight from
+ * main/SD_Logger/Telemetry.h, so this must be rebuilt whenever
+ * TLM_SCHEMA_VERSION changes.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -Imain/SD_Logger -Imain/Sensor tools/tlm_decode/tlm_decode.c \
+ *      main/SD_Logger/Telemetry.c -lm -o tlm_decode
+ *   ./tlm_decode T00012.bin > T00012.csv
+ *
+ * Output is one CSV line per record, first field the record type:
+ *   S,timestamp_us,seq,{raw_mv,temp_c,flags} x channels,supply_mv
+ *   P,timestamp_us,seq,edge,mode,duration_ms,timing_us,lead_ms
+ *   C,timestamp_us,seq,mode,state,flags,trigger_c,duty,duration_ms,interval_s,cycles
+ *   H,timestamp_us,seq,event,channel,value,detail
+ * preceded by "#" lines with the header (wall clock base, calibration).
+ * Records with a bad CRC are skipped by scanning forward for the next
+ * sync byte; CRC failures and sequence gaps are counted on stderr. A
+ * record-sized run of zeros is the padding after the last write of a
+ * preallocated file that was never closed (main/SD_Logger/Log_File.h) and
+ * ends the data.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Telemetry.h"
+
+static const char *edge_name(uint8_t e)
+{
+    switch (e) {
+        case TLM_SPRAY_ON:    return "on";
+        case TLM_SPRAY_OFF:   return "off";
+        case TLM_SPRAY_ABORT: return "abort";
+        default:              return "?";
+    }
+}
+
+static const char *health_name(uint8_t e)
+{
+    switch (e) {
+        case TLM_HEALTH_BROWNOUT:    return "brownout";
+        case TLM_HEALTH_SUPPLY_OK:   return "supply_ok";
+        case TLM_HEALTH_PROBE_FAULT: return "probe_fault";
+        case TLM_HEALTH_PROBE_OK:    return "probe_ok";
+        case TLM_HEALTH_LOG_DROP:    return "log_drop";
+        default:                     return "?";
+    }
+}
+
+static void print_record(const tlm_record_t *r)
+{
+    long long t = (long long)r->timestamp_us;
+    switch (r->type) {
+    case TLM_TYPE_SENSOR:
+        printf("S,%lld,%u", t, (unsigned)r->seq);
+        for (int ch = 0; ch < SENSOR_MAX_CHANNELS; ch++) {
+            printf(",%d,", r->p.sensor.raw_mv[ch]);
+            if (r->p.sensor.temp_centi_c[ch] == TLM_TEMP_INVALID) {
+                printf("nan");
+            } else {
+                printf("%.2f", r->p.sensor.temp_centi_c[ch] / 100.0);
+            }
+            printf(",0x%02X", r->p.sensor.flags[ch]);
+        }
+        printf(",%d\n", r->p.sensor.supply_mv);
+        break;
+    case TLM_TYPE_SPRAY:
+        printf("P,%lld,%u,%s,%u,%lu,%ld,%lu\n", t, (unsigned)r->seq, edge_name(r->p.spray.edge),
+               r->p.spray.mode, (unsigned long)r->p.spray.duration_ms, (long)r->p.spray.timing_us,
+               (unsigned long)r->p.spray.lead_ms);
+        break;
+    case TLM_TYPE_CONTROL:
+        printf("C,%lld,%u,%u,%u,0x%02X,%.2f,%.3f,%u,%u,%lu\n", t, (unsigned)r->seq, r->p.control.mode,
+               r->p.control.state, r->p.control.flags, r->p.control.trigger_centi_c / 100.0,
+               r->p.control.duty_permille / 1000.0, r->p.control.duration_ms, r->p.control.interval_s,
+               (unsigned long)r->p.control.cycles);
+        break;
+    case TLM_TYPE_HEALTH:
+        printf("H,%lld,%u,%s,%u,%ld,0x%lX\n", t, (unsigned)r->seq, health_name(r->p.health.event),
+               r->p.health.channel, (long)r->p.health.value, (unsigned long)r->p.health.detail);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s T00000.bin\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    tlm_file_header_t h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || !Telemetry_Check_Header(&h)) {
+        fprintf(stderr, "%s: not a schema %d telemetry file (or corrupt header)\n", argv[1], TLM_SCHEMA_VERSION);
+        return 1;
+    }
+    const tlm_calib_t *c = &h.calib;
+    printf("# log %lu, schema %u, %u channels, control channel %u, %u Hz\n", (unsigned long)h.log_seq,
+           (unsigned)h.schema, (unsigned)h.channels, (unsigned)c->control_channel, (unsigned)c->publish_hz);
+    printf("# T0,epoch_us=%lld,timestamp_us=%lld\n", (long long)h.epoch_us, (long long)h.timestamp_us);
+    printf("# thermistor model %u: R0=%.1f T0=%.2f beta=%.1f series=%.1f sh=%.9g,%.9g,%.9g\n",
+           (unsigned)c->therm_model, c->nominal_r, c->nominal_t, c->beta, c->series_r,
+           c->sh_a, c->sh_b, c->sh_c);
+    printf("# supply x%.4f, brown-out %d mV, recover %d mV\n", c->supply_scale, c->brownout_mv, c->recover_mv);
+
+    /* Records are fixed size, but after a bad one resync byte by byte */
+    unsigned long good = 0, bad = 0, gaps = 0;
+    uint8_t buf[TLM_RECORD_BYTES];
+    size_t have = 0;
+    bool first = true;
+    uint16_t next_seq = 0;
+    for (;;) {
+        size_t n = fread(buf + have, 1, sizeof(buf) - have, f);
+        have += n;
+        if (have < sizeof(buf)) {
+            break;
+        }
+        static const uint8_t zero[TLM_RECORD_BYTES];
+        if (memcmp(buf, zero, sizeof(buf)) == 0) {
+            break;
+        }
+        tlm_record_t r;
+        memcpy(&r, buf, sizeof(r));
+        if (!Telemetry_Check(&r)) {
+            bad++;
+            uint8_t *s = memchr(buf + 1, TLM_SYNC, sizeof(buf) - 1);
+            size_t skip = s ? (size_t)(s - buf) : sizeof(buf);
+            memmove(buf, buf + skip, sizeof(buf) - skip);
+            have -= skip;
+            continue;
+        }
+        if (!first && r.seq != next_seq) {
+            gaps++;
+        }
+        first = false;
+        next_seq = (uint16_t)(r.seq + 1);
+        print_record(&r);
+        good++;
+        have = 0;
+    }
+    fclose(f);
+
+    fprintf(stderr, "%lu records, %lu bad CRC / resync steps, %lu sequence gaps, %zu trailing bytes\n",
+            good, bad, gaps, have);
+    return 0;
+}